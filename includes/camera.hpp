@@ -0,0 +1,57 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name CellViewport
+ * @brief The part of the maze grid on screen for one frame, and where each cell edge lands in screen
+ * pixels. Cells are [x0, x1) x [y0, y1). Edges are floored, so neighboring cells tile without gaps or overlap.
+ * At zoom 1 with no pan a cell is exactly cellSize pixels at cellX * cellSize.
+ * @struct CellViewport
+ */
+struct CellViewport {
+    int cellSize;
+    double zoom;
+    double offsetX, offsetY;    // World pixel at the screen's top left corner
+    int x0, y0, x1, y1;
+
+    [[nodiscard]] int edgeX(int cellX) const { return (int) std::floor((cellX * (double) cellSize - offsetX) * zoom); }
+    [[nodiscard]] int edgeY(int cellY) const { return (int) std::floor((cellY * (double) cellSize - offsetY) * zoom); }
+    [[nodiscard]] bool contains(int cellX, int cellY) const {
+        return cellX >= x0 && cellX < x1 && cellY >= y0 && cellY < y1;
+    }
+    [[nodiscard]] int width() const { return x1 - x0; }
+    [[nodiscard]] int height() const { return y1 - y0; }
+    bool operator==(const CellViewport& other) const {
+        return cellSize == other.cellSize && zoom == other.zoom && offsetX == other.offsetX &&
+            offsetY == other.offsetY && x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+    }
+    bool operator!=(const CellViewport& other) const { return !(*this == other); }
+    static CellViewport covering(int cellSize, double zoom, double offsetX, double offsetY,
+        int cellsX, int cellsY, int width, int height);
+};
+
+/**
+ * @name Camera
+ * @author Hayden Beadles
+ * @brief Zoom and pan over the maze. World coordinates are maze pixels (cell * cell size), the camera
+ * maps them to the screen as (world - offset) * zoom. Driven by Game::processInput.
+ */
+class Camera {
+
+public:
+    Camera() = default;
+    void reset();
+    void fit(double worldWidth, double worldHeight, int screenWidth, int screenHeight);
+    void zoomAt(double factor, double screenX, double screenY);
+    void pan(double screenDX, double screenDY);
+    void clamp(double worldWidth, double worldHeight, int screenWidth, int screenHeight);
+    [[nodiscard]] CellViewport viewport(int cellSize, int cellsX, int cellsY, int screenWidth, int screenHeight) const;
+    [[nodiscard]] double getZoom() const { return zoom; }
+
+private:
+    double zoom = 1.0;
+    double offsetX = 0.0;
+    double offsetY = 0.0;
+    static constexpr double minZoom = 1.0 / 512.0;
+    static constexpr double maxZoom = 16.0;
+};
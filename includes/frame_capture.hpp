@@ -0,0 +1,101 @@
+#pragma once
+#include <common.hpp>
+#include <pixel_format.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+
+/**
+ * @name CaptureFormat
+ * @brief What a capture writes: numbered PNG files, or one raw RGBA stream (8 bits per channel, no
+ * header, frames back to back) for an external encoder
+ */
+enum CaptureFormat {
+    CAPTURE_PNG,
+    CAPTURE_RAW
+};
+
+/**
+ * @name CaptureSettings
+ * @brief Capture options, from the command line (see parseCaptureArgs) or the UI
+ * @struct CaptureSettings
+ */
+struct CaptureSettings {
+    bool startOnLaunch = false;
+    CaptureFormat format = CAPTURE_PNG;
+    int every = 1;                  // Keep every Nth drawn frame
+    int bufferCount = 8;            // Frames that can wait for the workers before new ones are dropped
+    int workerCount = 2;            // Encoding threads, a raw stream is still written in frame order
+    std::string output = "frame.png";   // PNG: numbered per frame. Raw: a file, or "-" for stdout
+};
+
+/**
+ * @name FrameCapture
+ * @author Hayden Beadles
+ * @brief Records drawn frames without holding up the main loop. submit copies the frame into a free
+ * buffer from a fixed pool and queues it; worker threads encode and write the queued frames, then hand
+ * the buffers back. When every buffer is still queued the frame is dropped and counted instead, so slow
+ * disks or a slow encoder on the other end of the pipe cost frames, never frame time.
+ * Raw frames are converted to RGBA byte order and written in the order they were taken, whichever
+ * worker finishes first. Every raw frame has the size of the first one, frames of another size are
+ * dropped.
+ * Web builds without pthreads have no workers and can't capture.
+ */
+class FrameCapture {
+
+public:
+    FrameCapture() = default;
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    bool start(const CaptureSettings& settings, PixelLayout layout);
+    void stop();
+    void submit(const Uint32* pixels, int width, int height);
+    [[nodiscard]] bool isActive() const { return active; }
+    [[nodiscard]] Uint64 getQueued() const { return queuedFrames; }
+    [[nodiscard]] Uint64 getWritten() const { return writtenFrames; }
+    [[nodiscard]] Uint64 getDropped() const { return droppedFrames; }
+    [[nodiscard]] Uint64 getFailed() const { return failedFrames; }
+    [[nodiscard]] int getBuffersInUse();
+    [[nodiscard]] int getBufferCount() const { return (int) buffers.size(); }
+    static bool isSupported();
+
+private:
+    struct Buffer {
+        std::vector<Uint32> pixels;
+        int width = 0;
+        int height = 0;
+        Uint64 sequence = 0;        // Order the frame was taken in, raw frames are written in it
+    };
+    CaptureSettings settings;
+    PixelLayout layout = LAYOUT_ARGB;
+    bool active = false;
+    std::vector<Buffer> buffers;
+    std::vector<int> freeBuffers;
+    std::deque<int> queue;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work;   // Queue has a frame, or capture is stopping
+    std::mutex streamMutex;         // Raw writes, separate so submit never waits on one
+    std::condition_variable turn;   // A raw frame was written, the next one may go
+    bool stopping = false;
+    Uint64 offeredFrames = 0;       // Every submit, for keeping every Nth
+    Uint64 nextSequence = 0;
+    Uint64 nextWrite = 0;           // Sequence of the next raw frame to write, under streamMutex
+    FILE* stream = nullptr;
+    bool sigpipeIgnored = false;
+    void (*previousSigpipe)(int) = nullptr;  // Handler to put back when the raw capture stops
+    int streamWidth = 0;
+    int streamHeight = 0;
+    std::atomic<Uint64> queuedFrames{0};
+    std::atomic<Uint64> writtenFrames{0};
+    std::atomic<Uint64> droppedFrames{0};
+    std::atomic<Uint64> failedFrames{0};
+    void workerLoop();
+    bool writePng(const Buffer& buffer);
+    bool writeRaw(const Buffer& buffer, std::vector<Uint32>& converted);
+};
+
+bool parseCaptureArgs(int argc, char** argv, CaptureSettings& settings);
@@ -0,0 +1,55 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name FrameScheduler
+ * @author Hayden Beadles
+ * @brief Paces the main loop and the maze generation separately.
+ * Frames: when the renderer presents with vsync and that actually blocks, present does the pacing and
+ * nothing waits here. Otherwise the loop sleeps until the next frame deadline with SDL_Delay, trimmed by
+ * how much SDL_Delay tends to oversleep. Deadlines advance by the frame length rather than from when
+ * the wait ended, so a late wakeup is made up on the next frame and the average rate stays on target.
+ * Generation: a fixed timestep accumulator hands out simulation steps of stepMs, so the maze grows at
+ * the same speed whatever the frame rate.
+ * Static frames: when nothing on screen would change, the loop blocks in waitForEvent instead. The
+ * simulation jumps over the wait, the caller bounds it by the next thing due to happen.
+ * Also measures the process CPU utilization, smoothed over about half a second.
+ * The browser paces web builds with requestAnimationFrame, there the scheduler never waits.
+ */
+class FrameScheduler {
+
+public:
+    explicit FrameScheduler(double targetFps = 60.0, double stepMs = 16.0);
+    void configure(SDL_Renderer* renderer);
+    void waitForNextFrame();
+    bool nextStep(Uint32& simulationTime);
+    bool waitForEvent(SDL_Event& event, int timeoutMs);
+    [[nodiscard]] Uint32 getSimulationTime() const { return (Uint32) simulationMs; }
+    [[nodiscard]] double getFrameMs() const { return frameMs; }
+    [[nodiscard]] double getCpuUtilization() const { return cpuUtilization; }
+    [[nodiscard]] bool isVsyncPacing() const { return vsyncPacing; }
+    [[nodiscard]] int getStepsLastFrame() const { return stepsThisFrame; }
+
+private:
+    Uint64 frequency;
+    Uint64 deadline = 0;            // Performance counter value the next frame may start at
+    Uint64 lastFrameStart = 0;
+    Uint64 idleTicks = 0;           // Spent blocked in waitForEvent since the last frame started
+    double targetMs;
+    double stepMs;
+    double frameMs = 0.0;
+    double accumulatorMs = 0.0;
+    double simulationMs = 0.0;
+    double oversleepMs = 1.0;       // Running estimate of how late SDL_Delay wakes up
+    bool vsyncPacing = false;
+    int fastFrames = 0;
+    int stepsThisFrame = 0;
+    double cpuSeconds = 0.0;
+    Uint64 cpuSampleStart = 0;
+    double cpuUtilization = 0.0;
+    static constexpr int maxStepsPerFrame = 8;      // After a stall, drop steps rather than spiral
+    static constexpr double vsyncMinFrameMs = 3.0;  // Faster than this, "vsync" isn't blocking
+    [[nodiscard]] double toMs(Uint64 ticks) const { return (double) ticks * 1000.0 / (double) frequency; }
+    void sampleCpu(Uint64 now);
+    static double processCpuSeconds();
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name FramePhase
+ * @brief The parts of a frame FrameTimer keeps track of
+ */
+enum FramePhase {
+    PHASE_UPDATE,
+    PHASE_RASTER,
+    PHASE_UPLOAD,
+    PHASE_PRESENT,
+    PHASE_COUNT
+};
+
+/**
+ * @name FrameTimer
+ * @author Hayden Beadles
+ * @brief Times each phase of a frame with the performance counter. A phase can be entered several
+ * times per frame, endFrame folds the totals into a smoothed average so the UI readout is stable.
+ */
+class FrameTimer {
+
+public:
+    FrameTimer();
+    void begin(FramePhase phase);
+    void end(FramePhase phase);
+    void endFrame();
+    [[nodiscard]] double getMs(FramePhase phase) const { return smoothedMs[phase]; }
+    static const char* phaseName(FramePhase phase);
+
+private:
+    Uint64 frequency;
+    Uint64 started[PHASE_COUNT]{};
+    double frameMs[PHASE_COUNT]{};
+    double smoothedMs[PHASE_COUNT]{};
+    static constexpr double smoothing = 0.1;
+};
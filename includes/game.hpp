@@ -1,6 +1,12 @@
 #pragma once
 #include <common.hpp>
 #include <maze_complex.hpp>
+#include <frame_timer.hpp>
+#include <texture_pool.hpp>
+#include <camera.hpp>
+#include <frame_scheduler.hpp>
+#include <pixel_format.hpp>
+#include <frame_capture.hpp>
 
 /**
  * @class Game
@@ -14,10 +20,21 @@ class Game{
         Game();
         explicit Game(Application & app);
         bool initialize(const std::string& title);
+        bool initializeHeadless(int width, int height, const MazeRenderConfig& config);
+        void generateHeadless();
+        void drawHeadless(Uint32 time);
+        bool saveFrame(const std::string& path);
         void runloop();
         void shutdown();
         Application app{};
         MazeRenderConfig renderConfig;
+        FrameTimer frameTimer;
+        TexturePool texturePool;
+        Camera camera;
+        FrameScheduler scheduler;
+        PixelLayout pixelLayout = LAYOUT_ARGB;  // Negotiated with the renderer, everything is rasterized in it
+        FrameCapture capture;
+        CaptureSettings captureSettings;
         void processInput();
         void updateGame();
         void generateOutput();
@@ -26,16 +43,21 @@ class Game{
 
     private:
         void renderUI(bool * openFlag);
+        void processCameraInput(const SDL_Event& event);
+        void clampCamera();
+        bool isStaticFrame();
+        void startCapture();
+        bool isCaptureSource() const;
         ColorConfig colorConfig;
         MazeRenderConfig currentStateConfig;
         MazeComplex mazeComplexObject;
         SDL_Window* mWindow{};
         SDL_Renderer* mRenderer{};
         Uint32 mTicksCount;
-        int uiNumRooms=0;
-        int uiRoomWidth = 5;
-        int uiRoomHeight = 5;
-        bool uiParamsChanged = false;
+        ConfigImpact pendingImpact = NO_CHANGE;
+        bool idle = false;              // Last frame was static, wait for events instead of polling
+        int activeFrames = 0;           // Frames left to draw after the last input
+        static constexpr int settleFrames = 3;
 
 
 };
\ No newline at end of file
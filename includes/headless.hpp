@@ -0,0 +1,24 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name HeadlessOptions
+ * @brief Command line settings for a headless run, see headlessUsage
+ * @struct HeadlessOptions
+ */
+struct HeadlessOptions {
+    int width = 1024;
+    int height = 1024;
+    int cellSize = 4;
+    int gridWidth = 0;          // 0 fits the image at cellSize
+    int gridHeight = 0;
+    int rooms = 0;
+    unsigned int seed = 0;      // 0 is random, otherwise image i uses seed + i
+    int count = 1;
+    Uint32 time = 0;            // Color wave time the images are colored at
+    int benchFrames = 0;        // Re-rasterize this many animated frames and report the cost
+    std::string output = "maze.png";
+};
+
+bool parseHeadlessArgs(int argc, char** argv, HeadlessOptions& options, bool& valid);
+int runHeadless(const HeadlessOptions& options);
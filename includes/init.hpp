@@ -9,4 +9,5 @@
 
 
 bool initSDL(Application &app, const std::string& title);
+bool updateOutputSize(Application &app);
 void cleanup(Application &app);
\ No newline at end of file
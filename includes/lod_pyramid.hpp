@@ -0,0 +1,47 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name LodBlock
+ * @brief Totals over a square block of cells: how many are visited, the sum of their path distances
+ * and how many walls are standing. Totals rather than averages so they can be updated exactly.
+ * @struct LodBlock
+ */
+struct LodBlock {
+    Uint32 visited;
+    Uint32 walls;
+    Uint64 distanceSum;
+};
+
+/**
+ * @name LodPyramid
+ * @author Hayden Beadles
+ * @brief Mip pyramid of the maze for drawing it zoomed out, when many cells land on one pixel.
+ * Level L holds one LodBlock per 2^L x 2^L cells, up to the level where one block covers the grid.
+ * Built once per maze, then every carve or reveal walks the handful of blocks above the cell, so it
+ * stays current during generation. About a third of a block per cell, ~5 bytes.
+ */
+class LodPyramid {
+
+public:
+    LodPyramid() = default;
+    void build(int cellsX, int cellsY, const MazeElement* maze, const Uint32* distance, const Uint8* walls);
+    void addVisited(int x, int y, Uint32 distance);
+    void removeWall(int x, int y);
+    [[nodiscard]] int levelFor(double cellsPerPixel) const;
+    [[nodiscard]] int getLevelCount() const { return (int) levels.size(); }
+    [[nodiscard]] int getLevelWidth(int level) const { return widths[level - 1]; }
+    [[nodiscard]] int getLevelHeight(int level) const { return heights[level - 1]; }
+    [[nodiscard]] const LodBlock& block(int level, int x, int y) const {
+        return levels[level - 1][(size_t) y * widths[level - 1] + x];
+    }
+    [[nodiscard]] int blockCells(int level, int x, int y) const;
+    [[nodiscard]] size_t getBytes() const;
+
+private:
+    int cellsX = 0;
+    int cellsY = 0;
+    std::vector<std::vector<LodBlock>> levels;  // levels[0] is level 1, 2x2 cells per block
+    std::vector<int> widths;
+    std::vector<int> heights;
+};
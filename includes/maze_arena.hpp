@@ -0,0 +1,99 @@
+#pragma once
+#include <common.hpp>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+/**
+ * @name ArenaArray
+ * @brief Non-owning view of an array handed out by MazeArena. Only valid until the arena is reset.
+ * @struct ArenaArray
+ */
+template<typename T>
+struct ArenaArray {
+    T* data = nullptr;
+    int count = 0;
+
+    T& operator[](int index) { return data[index]; }
+    const T& operator[](int index) const { return data[index]; }
+    T* begin() { return data; }
+    T* end() { return data + count; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+    [[nodiscard]] int size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+};
+
+/**
+ * @name MazeArena
+ * @author Hayden Beadles
+ * @brief Bump allocator that owns all storage for one maze (cells, structures, distance field, masks,
+ * frontier). Everything allocated during a maze's lifetime is dropped together by reset(), which is
+ * O(1): it just rewinds the offset. Memory comes from an upstream std::pmr::memory_resource.
+ * If a maze needs more than the current block, the extra comes from overflow chunks, and the next
+ * reset() swaps everything for a single block sized to that high-water mark. After the first
+ * regeneration at a given size, generate/reset cycles don't touch the heap at all.
+ * Only trivially destructible types can live here, nothing is ever destroyed.
+ */
+class MazeArena {
+
+public:
+    explicit MazeArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~MazeArena();
+    MazeArena(MazeArena&& other) noexcept;
+    MazeArena& operator=(MazeArena&& other) noexcept;
+    MazeArena(const MazeArena&) = delete;
+    MazeArena& operator=(const MazeArena&) = delete;
+
+    /**
+     * @name allocate
+     * @brief Hands out uninitialized storage for count objects of T, valid until the next reset()
+     * @param count - number of elements
+     * @return ArenaArray<T>
+     */
+    template<typename T>
+    ArenaArray<T> allocate(int count) {
+        static_assert(std::is_trivially_destructible_v<T>, "MazeArena never runs destructors");
+        ArenaArray<T> array;
+        array.data = static_cast<T*>(allocateBytes(sizeof(T) * (size_t) std::max(count, 0), alignof(T)));
+        array.count = count;
+        return array;
+    }
+    void reset();
+    [[nodiscard]] size_t getCapacity() const { return capacity; }
+    [[nodiscard]] size_t getUsed() const { return offset + overflowBytes; }
+
+private:
+    struct OverflowChunk {
+        OverflowChunk* next;
+        size_t size;
+    };
+    void* allocateBytes(size_t bytes, size_t alignment);
+    void releaseAll();
+    std::pmr::memory_resource* upstream;
+    std::byte* block = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    OverflowChunk* overflow = nullptr;
+    size_t overflowBytes = 0;
+};
+
+/**
+ * @name Frontier
+ * @brief The set of frontier cells, stored in arena memory. A dense list of cells plus a per-cell slot
+ * (-1 when the cell isn't in the frontier) makes insert, membership and removing a random cell O(1),
+ * where the old unordered_set needed an O(n) std::advance to pick a random cell.
+ * @struct Frontier
+ */
+struct Frontier {
+    ArenaArray<int> cells;
+    ArenaArray<int> slot;
+    int count = 0;
+
+    void attach(MazeArena& arena, int numCells);
+    void insert(int cell);
+    int takeAt(int index);
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] int size() const { return count; }
+};
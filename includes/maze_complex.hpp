@@ -1,5 +1,15 @@
 #pragma once
 #include <common.hpp>
+#include <occupancy_grid.hpp>
+#include <room_layout.hpp>
+#include <maze_arena.hpp>
+#include <raster.hpp>
+#include <thread_pool.hpp>
+#include <wall_geometry.hpp>
+#include <camera.hpp>
+#include <tile_cache.hpp>
+#include <lod_pyramid.hpp>
+#include <texture_ring.hpp>
 
 // Forward declaration
 class Game;
@@ -15,34 +25,139 @@ class MazeComplex {
 public:
     MazeComplex();
     MazeComplex(Game* game,
-        ColorConfig* config);
-    std::vector<int> getNeighbors(const MazeElement& current_element, bool visited);
+        ColorConfig* config,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    int getNeighbors(const MazeElement& current_element, bool visited, int (&nx)[4]);
     void resetMazeComplex();
     void initMazeComplex();
+    void updateRasterConfig();
     void updateMazeComplex(Uint32 currentTime);
     void displayMazeComplex(Uint32 currentTime);
-    void addRoom(int width, int height);
+    bool isFrameStatic(Uint32 currentTime);
+    [[nodiscard]] int getIdleTimeout(Uint32 simulationTime) const;
     void lookahead(Uint32 currentTime);
     void generateCompleteMaze();
-    void configureRooms(int numRooms, int width, int height);
+    void configureRooms(const RoomLayoutConfig& layout);
+    [[nodiscard]] int getPlacedRooms() const { return (int) placedRooms.size(); }
+    [[nodiscard]] int getRequestedRooms() const { return roomLayout.getLastRequested(); }
+    [[nodiscard]] double getRoomPlacementMs() const { return roomLayout.getLastPlacementMs(); }
+    [[nodiscard]] int getWallQuads() const { return gpuWalls && renderMode != RENDER_TILED ? wallGeometry.getQuadCount() : 0; }
+    [[nodiscard]] int getRasterThreads() const { return rasterPool ? rasterPool->getThreadCount() : 1; }
+    [[nodiscard]] int getGridWidth() const { return numCellX; }
+    [[nodiscard]] int getGridHeight() const { return numCellY; }
+    [[nodiscard]] double getWorldWidth() const { return (double) numCellX * pixelSize; }
+    [[nodiscard]] double getWorldHeight() const { return (double) numCellY * pixelSize; }
+    [[nodiscard]] int getVisibleCells() const { return view.width() * view.height(); }
+    [[nodiscard]] const TileCache& getTileCache() const { return tileCache; }
+    [[nodiscard]] int getOverviewLevel() const { return overviewLevel; }
+    [[nodiscard]] size_t getLodBytes() const { return lod.getBytes(); }
+    [[nodiscard]] const std::vector<Uint32>& getFramebuffer() const { return framebuffer; }
     bool configRenderMazePerFrame = true;
 
 private:
     int pixelSize;
     Game* game{};
     ColorConfig* mazeColorConfig{};
-    SDL_Texture* mazeTexture{};
+    TextureRing screenRing;             // Screen sized, the framebuffer (pixel mode) or the CPU wall overlay
     bool mazeComplete;
     int numCellX{};
     int numCellY{};
     SDL_Color background{};
     SDL_Color wallColor{};
-    void drawRectangle(Uint32* &pixelBuffer, int x, int y, int w, int h, const Uint32 & color);
-    std::vector<MazeElement> maze;
-    std::unordered_set<int> frontier;
+    Uint32 backgroundValue{};
+    Uint32 wallColorValue{};
+    MazeArena arena;
+    ArenaArray<MazeElement> maze;
+    ArenaArray<MazeStructure> structures;
+    int structureCount = 0;
+    ArenaArray<Uint32> pathDistance;
+    ArenaArray<Uint8> cellBoundary;
+    ArenaArray<Uint8> cellWalls;
+    ArenaArray<Uint8> cellDirty;        // Damage since the last displayMazeComplex, DIRTY_* flags
+    ArenaArray<int> dirtyCells;
+    int dirtyCount = 0;
+    bool fullRedraw = true;
+    std::vector<Uint32> framebuffer;    // CPU copy of screenRing, dirty cells are rasterized here
+    std::vector<Uint32> colorLut;       // Packed pixel per path distance, rebuilt every frame
+    std::vector<Uint32> previousLut;
+    std::vector<float> lutWave;
+    bool lutPrebuilt = false;           // isFrameStatic already built the LUT for lutPrebuiltTime
+    Uint32 lutPrebuiltTime = 0;
+    bool presentCurrent = false;        // The last drawn frame still shows the maze, only view changes are left
+    float presentedAngle = 0.0f;
+    ArenaArray<int> nextAtDistance;     // Cells bucketed by path distance, intrusive lists headed by distanceHead
+    std::vector<int> distanceHead;
+    std::vector<int> distanceCount;     // Cells per bucket, decides between walking buckets and scanning the view
+    static constexpr int lutBlock = 256;
+    std::vector<int> rowMinX, rowMaxX;
+    std::vector<SDL_Rect> dirtyRects;
+    CellViewport view{};                // Cells on screen this frame, nothing outside it is rasterized
+    RenderMode renderMode = RENDER_PIXEL;
+    TextureRing cellRing;               // Cell mode, one texel per cell
+    std::vector<Uint32> cellPixels;     // Viewport cells only, view.width() per row
+    std::vector<SDL_Rect> cellRects;
+    bool gpuWalls = true;
+    WallGeometry wallGeometry;
+    TileCache tileCache;                // Tiled mode
+    std::vector<Tile*> visibleTiles;
+    std::vector<Tile*> staleTiles;
+    std::vector<Uint32> tileScratch;    // Stale tiles are rasterized here in parallel, then uploaded
+    std::vector<int> tileColumns;       // Overview scratch per stale tile, see OverviewColumns
+    std::vector<Uint32> tileColors;
+    LodPyramid lod;                     // Zoomed out drawing, when cells are smaller than a pixel
+    int overviewLevel = 0;              // Pyramid level drawn last frame, 0 when drawing cells
+    /**
+     * @name OverviewColumns
+     * @brief Which pyramid block every column of an overview target falls in, the same on every row
+     * @struct OverviewColumns
+     */
+    struct OverviewColumns {
+        const int* blocks;              // -1 for columns off the grid
+        int firstBlock;
+        int lastBlock;                  // Below firstBlock when no column is on the grid
+    };
+    std::vector<int> overviewBlocks;    // Block column per screen column, shared by every band
+    OverviewColumns overviewColumns{};
+    std::vector<Uint32> overviewColors; // One slice of block colors per band
+    std::vector<SDL_Rect> wholeScreen;
+    static constexpr Uint8 DIRTY_COLOR = 1;
+    static constexpr Uint8 DIRTY_WALLS = 2;
+    static constexpr Uint32 TRANSPARENT_PIXEL = 0;
+    std::unique_ptr<ThreadPool> rasterPool;
+    static constexpr int parallelRasterCells = 4096;  // Below this splitting the raster costs more than it saves
+    Frontier frontier;
+    OccupancyGrid occupancy;
+    RoomLayout roomLayout;
+    std::vector<RoomRect> placedRooms;
     void chooseWallCandidate(int frontierCell);
-    SDL_Color generateColor(int distance, Uint32 time);
-    void mazeStructureNeighbors(std::vector<int> &nx, MazeElement& neighbor, bool visited);
+    void placeRoom(int sX, int sY, int width, int height);
+    void trackRoomReveal(int cell, Uint32 currentTime);
+    void revealRoom(MazeStructure& room, Uint32 currentTime);
+    void buildColorLut(Uint32 time);
+    void markDirty(int cell, Uint8 flags);
+    void addToDistanceBucket(int cell);
+    void advanceColorLut(Uint32 currentTime);
+    void refreshColorLut(Uint32 currentTime);
+    Uint32 cellColor(int cell);
+    void drawCell(const PixelTarget& target, const CellViewport& area, int cell, Uint32 fill, bool walls);
+    void rasterizeCell(int cell, Uint8 flags);
+    void rasterizeTile(Tile& tile, Uint32* pixels, int* columns, Uint32* colors);
+    void displayTiles(Uint32 currentTime);
+    Uint32 overviewColor(int level, int blockX, int blockY);
+    OverviewColumns mapOverviewColumns(const CellViewport& area, int level, int width, int* blocks);
+    void drawOverview(const PixelTarget& target, const CellViewport& area, int level, const OverviewColumns& columns,
+        Uint32* blockColor, int firstRow, int lastRow, Uint32& minDistance, Uint32& maxDistance);
+    void drawOverviewBand(int band, int bandCount);
+    void displayOverview(Uint32 currentTime);
+    void rasterizeBand(int band, int bandCount);
+    void rasterizeDirty();
+    PixelTarget framebufferTarget();
+    void collectDirtyRects(Uint8 mask, bool screenSpace, std::vector<SDL_Rect>& rects);
+    void clearDirty();
+    void applyRenderMode();
+    void ensureCellTexture();
+    void mazeStructureNeighbors(int (&nx)[4], int &count, const MazeElement& neighbor, bool visited);
+    void visitFrontierCell(int randomIndex, Uint32 currentTime);
     void removeWall(int cell1, int cell2);
     void checkCell(Direction direction, int one, int two);
     static Direction getOppositeDirection(Direction direction);
@@ -50,8 +165,6 @@ private:
     int maxDistance{};
     Uint32 mazeDisplayTime = 5000;
     Uint32 mazeCompletionTime = 0;
-    int configNumRooms = 0;
-    int configRoomWidth = 5;
-    int configRoomHeight = 5;
+    RoomLayoutConfig roomConfig;
 
 };
\ No newline at end of file
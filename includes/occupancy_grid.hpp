@@ -0,0 +1,42 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name OccupancyGrid
+ * @author Hayden Beadles
+ * @brief Tracks which grid cells are already claimed by a structure. A summed-area table
+ * over the occupancy bitmap answers "is this rectangle free?" in O(1) for big rectangles, which
+ * lets RoomLayout test positions without scanning the room's area cell by cell. Room sized ones are
+ * cheaper to read straight off the bitmap, a few short rows.
+ * Claims made since the table was last built sit in a pending list that queries also check.
+ * The table is rebuilt lazily, by the first query that finds the list too long, so a burst of
+ * claims with no queries in between (the packers) never pays for a rebuild.
+ */
+class OccupancyGrid {
+
+public:
+    OccupancyGrid() = default;
+    void reset(int width, int height);
+    [[nodiscard]] bool isFree(int x, int y, int w, int h, int margin = 0) const;
+    [[nodiscard]] bool isOccupied(int x, int y) const;
+    void occupy(int x, int y, int w, int h);
+    int findFreePositions(int w, int h, std::vector<int> &positions, int margin = 0);
+    int findFreePositions(int w, int h, const std::vector<int>& from, std::vector<int>& positions, int margin = 0);
+    [[nodiscard]] int getWidth() const { return gridWidth; }
+    [[nodiscard]] int getHeight() const { return gridHeight; }
+
+private:
+    struct PendingRect {
+        int x0, y0, x1, y1;
+    };
+    int gridWidth = 0;
+    int gridHeight = 0;
+    size_t maxPending = 64;
+    static constexpr int directScanCells = 1024;    // Up to this area, anyOccupied may read the bitmap
+    static constexpr size_t shortPending = 16;      // Pending claims checked one by one without a second thought
+    std::vector<Uint8> occupied;
+    mutable std::vector<int> summedArea;
+    mutable std::vector<PendingRect> pending;
+    void rebuildSummedArea() const;
+    [[nodiscard]] bool anyOccupied(int x0, int y0, int x1, int y1) const;
+};
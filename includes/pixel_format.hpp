@@ -0,0 +1,38 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name PixelLayout
+ * @brief Channel order of the 32 bit pixels the maze rasterizes, named like SDL's packed formats, most
+ * significant byte first. Each one has an alpha channel, cell mode's wall overlay needs it.
+ */
+enum PixelLayout {
+    LAYOUT_ARGB,
+    LAYOUT_ABGR,
+    LAYOUT_RGBA,
+    LAYOUT_BGRA
+};
+
+/**
+ * @name packColor
+ * @brief Packs a color for one layout, resolved at compile time
+ * @tparam layout - PixelLayout
+ * @param r, g, b, a - channels
+ * @return Uint32 - packed pixel
+ */
+template <PixelLayout layout>
+constexpr Uint32 packColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a){
+    if constexpr (layout == LAYOUT_ARGB) {
+        return ((Uint32) a << 24) | ((Uint32) r << 16) | ((Uint32) g << 8) | b;
+    } else if constexpr (layout == LAYOUT_ABGR) {
+        return ((Uint32) a << 24) | ((Uint32) b << 16) | ((Uint32) g << 8) | r;
+    } else if constexpr (layout == LAYOUT_RGBA) {
+        return ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | a;
+    } else {
+        return ((Uint32) b << 24) | ((Uint32) g << 16) | ((Uint32) r << 8) | a;
+    }
+}
+
+Uint32 packColor(PixelLayout layout, const SDL_Color& color);
+Uint32 pixelFormatFor(PixelLayout layout);
+PixelLayout negotiatePixelLayout(SDL_Renderer* renderer);
@@ -0,0 +1,26 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @file raster.hpp
+ * @brief Solid fill kernels for 32 bit pixel buffers. Rectangles are clipped once up front and
+ * rows are filled with the widest kernel the CPU supports (AVX2, SSE2 or scalar, picked at startup).
+ * @author Hayden Beadles
+ */
+
+/**
+ * @name PixelTarget
+ * @brief A 32 bit pixel buffer to draw into. stride is in pixels, not bytes.
+ * @struct PixelTarget
+ */
+struct PixelTarget {
+    Uint32* pixels;
+    int width;
+    int height;
+    int stride;
+};
+
+void fillRect(const PixelTarget& target, int x, int y, int w, int h, Uint32 color);
+void fillHLine(const PixelTarget& target, int x, int y, int w, Uint32 color);
+void fillVLine(const PixelTarget& target, int x, int y, int h, Uint32 color);
+const char* rasterKernelName();
@@ -0,0 +1,71 @@
+#pragma once
+#include <common.hpp>
+#include <occupancy_grid.hpp>
+
+/**
+ * @name RoomRect
+ * @brief Position and size of a placed room, in cells
+ * @struct RoomRect
+ */
+struct RoomRect {
+    int x, y;
+    int width, height;
+};
+
+/**
+ * @name RoomLayout
+ * @author Hayden Beadles
+ * @brief Room layout engine. Draws room sizes from a distribution, then positions them with one of
+ * the RoomPacking strategies:
+ * 1. PACK_RANDOM scatters rooms, using O(1) occupancy lookups with an exhaustive fallback
+ * 2. PACK_SKYLINE packs rooms bottom-left against a skyline, dense and fast for similar heights
+ * 3. PACK_GUILLOTINE splits free rectangles, best for mixed sizes
+ * Placed rooms are claimed in the OccupancyGrid. The skyline and guillotine packers never overlap
+ * rooms by construction and expect an empty grid. Scratch storage is kept between calls.
+ * Candidate positions for a room size, the free indices and the widest free room per height are cached
+ * for the lifetime of one grid. Call generate (which resets them) before placing rooms into a freshly
+ * reset OccupancyGrid.
+ */
+class RoomLayout {
+
+public:
+    RoomLayout() = default;
+    int generate(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms);
+    bool placeRandom(OccupancyGrid& occupancy, int width, int height, int spacing, RoomRect& room);
+    [[nodiscard]] double getLastPlacementMs() const { return lastPlacementMs; }
+    [[nodiscard]] int getLastRequested() const { return lastRequested; }
+
+private:
+    struct SkylineSegment {
+        int x, y, width;
+    };
+    struct FreeTier {
+        int width = 0;
+        int height = 0;
+        bool built = false;
+        std::vector<int> positions;     // Where a width x height room fits, or used to
+    };
+    static constexpr int tierLevels = 8;
+    void sampleSizes(const RoomLayoutConfig& config);
+    std::vector<int>& freeIndex(OccupancyGrid& occupancy, int width, int height, int spacing, FreeTier*& tier);
+    bool probeFreeIndex(OccupancyGrid& occupancy, std::vector<int>& index, int tierWidth, int tierHeight,
+        int width, int height, int spacing, RoomRect& room);
+    void packRandom(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms);
+    void packSkyline(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms);
+    void packGuillotine(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms);
+    std::vector<RoomRect> sizes;
+    std::vector<int> candidates;
+    int candidateWidth = 0;
+    int candidateHeight = 0;
+    int candidateSpacing = -1;
+    std::vector<int> widestFree;        // Widest room per height that may still fit, see placeRandom
+    int widestSpacing = -1;
+    FreeTier freeTiers[tierLevels * tierLevels];    // See freeIndex, by doublings in height then width
+    int freeSpacing = -1;
+    int smallestWidth = 1;              // Smallest room size of the last generate
+    int smallestHeight = 1;
+    std::vector<SkylineSegment> skyline;
+    std::vector<RoomRect> freeRects;
+    double lastPlacementMs = 0.0;
+    int lastRequested = 0;
+};
@@ -4,14 +4,85 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <algorithm>
 
 typedef struct Application Application;
 typedef struct MazeElement MazeElement;
 typedef struct MazeStructure MazeStructure;
-typedef struct PerimeterCell PerimeterCell;
 typedef struct ColorConfig ColorConfig;
 typedef struct MazeRenderConfig MazeRenderConfig;
 
+/**
+ * @name ConfigImpact
+ * @brief How much work a MazeRenderConfig change requires, ordered from cheapest to most expensive.
+ * VIEW_CHANGE only needs a re-present, RASTER_CHANGE re-rasterizes the existing maze,
+ * TOPOLOGY_CHANGE regenerates it.
+ */
+enum ConfigImpact {
+    NO_CHANGE,
+    VIEW_CHANGE,
+    RASTER_CHANGE,
+    TOPOLOGY_CHANGE
+};
+
+/**
+ * @name RoomPacking
+ * @brief Strategy used by RoomLayout to position rooms
+ */
+enum RoomPacking {
+    PACK_RANDOM,
+    PACK_SKYLINE,
+    PACK_GUILLOTINE
+};
+
+/**
+ * @name RoomSizeDistribution
+ * @brief How room sizes are drawn between the configured minimum and maximum
+ */
+enum RoomSizeDistribution {
+    SIZE_FIXED,
+    SIZE_UNIFORM,
+    SIZE_SMALL_BIASED
+};
+
+/**
+ * @name RoomLayoutConfig
+ * @brief Everything RoomLayout needs to place the rooms of one maze
+ * @struct RoomLayoutConfig
+ */
+struct RoomLayoutConfig {
+    int numRooms = 0;
+    int minWidth = 5;
+    int minHeight = 5;
+    int maxWidth = 5;
+    int maxHeight = 5;
+    int spacing = 1;
+    RoomPacking packing = PACK_RANDOM;
+    RoomSizeDistribution distribution = SIZE_FIXED;
+};
+
+/**
+ * @name RenderMode
+ * @brief How MazeComplex turns cells into pixels. RENDER_PIXEL rasterizes every pixel on the CPU,
+ * RENDER_CELL uploads one texel per cell and leaves the upscale to the GPU, RENDER_TILED rasterizes
+ * into cached tile textures so panning around a big maze is just blits.
+ */
+enum RenderMode {
+    RENDER_PIXEL,
+    RENDER_CELL,
+    RENDER_TILED
+};
+
+/**
+ * @name UploadMethod
+ * @brief How pixels get into a streaming texture. SDL_UpdateTexture copies from our buffer, SDL_LockTexture
+ * hands out the backend's staging memory to copy into. Which one is faster depends on the backend.
+ */
+enum UploadMethod {
+    UPLOAD_UPDATE,
+    UPLOAD_LOCK
+};
+
 struct MazeRenderConfig {
     bool renderByFrame;
     int numRooms;
@@ -19,15 +90,62 @@ struct MazeRenderConfig {
     int roomHeight;
     int pixelSize = 10;
     float angle = 0.0f;
+    unsigned int seed = 0; // 0 picks a fresh random seed per maze
+    int roomMaxWidth = 5;
+    int roomMaxHeight = 5;
+    int roomSpacing = 1;
+    RoomPacking roomPacking = PACK_RANDOM;
+    RoomSizeDistribution roomDistribution = SIZE_FIXED;
+    RenderMode renderMode = RENDER_PIXEL;
+    bool gpuWalls = true;   // Walls as SDL_RenderGeometry quads instead of CPU raster
+    int gridWidth = 0;      // Maze size in cells, 0 fits the window at the current cell size
+    int gridHeight = 0;
+    int tileBudgetMB = 64;  // Texture memory the tiled mode may keep cached
+    int streamingTextures = 1;  // Textures per streamed image, more let uploads skip one the GPU is reading
+    UploadMethod uploadMethod = UPLOAD_UPDATE;  // Picked per backend at startup, see preferredUploadMethod
     static constexpr float epsilon = 1e-6f; // Baked right into the struct
+    // About 53 bytes per cell (generator state, LOD pyramid), ~900 MB at the cap
+    static constexpr int maxGridCells = 1 << 24;
 
     bool operator==(const MazeRenderConfig& other) const {
-        return renderByFrame == other.renderByFrame &&
-               numRooms == other.numRooms &&
-               roomWidth == other.roomWidth &&
-               roomHeight == other.roomHeight &&
-               pixelSize == other.pixelSize &&
-               std::abs(angle - other.angle) < epsilon; // Use the struct's epsilon
+        return classify(other) == NO_CHANGE;
+    }
+
+    /**
+     * @name classify
+     * @brief Compares against another config and returns the most expensive impact of the fields that differ.
+     * View: angle, renderByFrame (only paces generation), tileBudgetMB, uploadMethod.
+     * Raster: pixelSize, renderMode, gpuWalls, streamingTextures.
+     * Topology: rooms, seed and grid size.
+     * Colors live in ColorConfig and are read every frame, so they never show up here.
+     * @param other - config to compare against
+     * @return ConfigImpact
+     */
+    [[nodiscard]] ConfigImpact classify(const MazeRenderConfig& other) const {
+        if (numRooms != other.numRooms ||
+            roomWidth != other.roomWidth ||
+            roomHeight != other.roomHeight ||
+            roomMaxWidth != other.roomMaxWidth ||
+            roomMaxHeight != other.roomMaxHeight ||
+            roomSpacing != other.roomSpacing ||
+            roomPacking != other.roomPacking ||
+            roomDistribution != other.roomDistribution ||
+            seed != other.seed ||
+            gridWidth != other.gridWidth ||
+            gridHeight != other.gridHeight) {
+            return TOPOLOGY_CHANGE;
+        }
+        if (pixelSize != other.pixelSize || renderMode != other.renderMode || gpuWalls != other.gpuWalls ||
+            streamingTextures != other.streamingTextures) {
+            return RASTER_CHANGE;
+        }
+        if (renderByFrame != other.renderByFrame ||
+            tileBudgetMB != other.tileBudgetMB ||
+            uploadMethod != other.uploadMethod ||
+            std::abs(angle - other.angle) >= epsilon) { // Use the struct's epsilon
+            return VIEW_CHANGE;
+        }
+        return NO_CHANGE;
     }
     // Computes a hash of the configuration values.
     [[nodiscard]] size_t hash() const {
@@ -40,8 +158,40 @@ struct MazeRenderConfig {
         seed ^= int_hash(roomHeight) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         seed ^= int_hash(pixelSize) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         seed ^= std::hash<float>()(angle) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<unsigned int>()(this->seed) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(roomMaxWidth) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(roomMaxHeight) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(roomSpacing) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(roomPacking) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(roomDistribution) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(renderMode) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= bool_hash(gpuWalls) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(gridWidth) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(gridHeight) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(tileBudgetMB) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(streamingTextures) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= int_hash(uploadMethod) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         return seed;
     }
+
+    /**
+     * @name roomLayout
+     * @brief Room settings bundled for RoomLayout. roomWidth / roomHeight are the minimum size,
+     * the max fields only matter for non-fixed size distributions.
+     * @return RoomLayoutConfig
+     */
+    [[nodiscard]] RoomLayoutConfig roomLayout() const {
+        RoomLayoutConfig layout;
+        layout.numRooms = numRooms;
+        layout.minWidth = roomWidth;
+        layout.minHeight = roomHeight;
+        layout.maxWidth = std::max(roomWidth, roomMaxWidth);
+        layout.maxHeight = std::max(roomHeight, roomMaxHeight);
+        layout.spacing = roomSpacing;
+        layout.packing = roomPacking;
+        layout.distribution = roomDistribution;
+        return layout;
+    }
 };
 /**
  * @name StructureType
@@ -64,6 +214,17 @@ enum Direction {
     WEST
 };
 
+/**
+ * @name directionBit
+ * @brief Bit for a direction in the per-cell boundary and wall masks
+ * @param direction
+ * @return Uint8 - single bit mask
+ */
+inline Uint8 directionBit(Direction direction) {
+    return (Uint8) (1u << direction);
+}
+constexpr Uint8 ALL_DIRECTIONS = 0x0F;
+
 /**
  * @name ColorConfig
  * @brief Configuration for Maze coloration
@@ -78,46 +239,26 @@ struct ColorConfig {
     float timeCoef = .01f;
 };
 
-/**
- * @name PerimeterCell
- * @brief Represents a cell on the perimeter of a structure (Wall candidate)
- * @struct PerimeterCell
- */
-struct PerimeterCell {
-    Direction direction;
-    int cell;
-    bool visited;
-};
-
 /**
  * @name MazeStructure
  * @brief Higher level abstraction of a cell, contains metadata of a maze element
  * including informatin on its perimeter, start and end points, etc.
+ * Plain data so it can live in the MazeArena, cells and perimeter are derived from the rectangle.
  * @struct MazeStructure
  */
 struct MazeStructure {
-    bool visited;
+    bool visited;           // Rooms: set once every perimeter cell is visited and the room is revealed
     int width, height;
     int startX, startY;
-    std::vector<int> cells;
-    std::vector<PerimeterCell> perimeterCells;
     StructureType structure;
+    int perimeterSize;      // Distinct perimeter cells
+    int perimeterVisited;
 
-    MazeStructure(int width, int height, int gridX, int gridY, int numCellX)
-    :visited(false), width(width), height(height), startX(gridX), startY(gridY), structure(CELL)
+    MazeStructure(int width, int height, int gridX, int gridY)
+    :visited(false), width(width), height(height), startX(gridX), startY(gridY), structure(CELL),
+     perimeterSize((width <= 2 || height <= 2) ? width * height : 2 * (width + height) - 4),
+     perimeterVisited(0)
     {
-
-        for (int y = 0; y < height; y++){
-            for(int x = 0; x < width; x++){
-                int cellIndex = (startY + y) * numCellX + (startX + x);
-                cells.push_back(cellIndex);
-                
-                if (x == 0){ perimeterCells.push_back({WEST, cellIndex, true});}
-                if (x == (width -1)) {perimeterCells.push_back({EAST, cellIndex, true});}
-                if (y == 0) {perimeterCells.push_back({NORTH, cellIndex, true});}
-                if (y == (height -1)) {perimeterCells.push_back({SOUTH, cellIndex, true});}
-            }
-        }
     }
 
 };
@@ -133,21 +274,23 @@ struct MazeElement {
     int gridX;
     int gridY;
     int place;
-    std::shared_ptr<MazeStructure> parentStructure;
+    int parentStructure;    // Index into MazeComplex's structures, NO_STRUCTURE for a plain cell
 
     int generationTime;     // NEW: When this cell was processed
-    int distance;
 
-    MazeElement(int gridX, int gridY, int place, std::shared_ptr<MazeStructure> structure):
+    MazeElement(int gridX, int gridY, int place, int structure):
         visited(false), gridX(gridX), gridY(gridY), place(place),
-        parentStructure(std::move(structure)), generationTime(-1), distance(0) {
+        parentStructure(structure), generationTime(-1) {
     }
 };
+constexpr int NO_STRUCTURE = -1;
 
 /**
  * @name Application
  * @brief Main application structure holding SDL window, renderer, screen dimensions, delta time, etc.
  * Also contains ImGUI IO and style pointers for UI rendering.
+ * screenWidth / screenHeight are the renderer's output in physical pixels, pixelScale is physical pixels
+ * per window unit (2 on a typical HiDPI panel).
  * @struct Application
  */
 struct Application {
@@ -155,6 +298,7 @@ struct Application {
     SDL_Renderer* renderer;
     int screenWidth;
     int screenHeight;
+    float pixelScale;
     double deltaTime;
     ImGuiIO* io;
     ImGuiStyle* style;
@@ -0,0 +1,40 @@
+#pragma once
+#include <common.hpp>
+
+/**
+ * @name TexturePool
+ * @author Hayden Beadles
+ * @brief Owns every texture the maze renders with. acquire hands back an idle texture when one with the
+ * same format, access and size exists, otherwise it creates one. release marks a texture idle, and
+ * trim destroys whatever is still idle, so textures left over from a resize or cell size change
+ * don't pile up. Reports how many textures are alive and roughly how much memory they take.
+ */
+class TexturePool {
+
+public:
+    TexturePool() = default;
+    ~TexturePool();
+    TexturePool(const TexturePool&) = delete;
+    TexturePool& operator=(const TexturePool&) = delete;
+    SDL_Texture* acquire(SDL_Renderer* renderer, Uint32 format, int access, int width, int height);
+    void release(SDL_Texture* texture);
+    void trim();
+    void destroyAll();
+    [[nodiscard]] int getTextureCount() const { return (int) entries.size(); }
+    [[nodiscard]] int getIdleCount() const;
+    [[nodiscard]] size_t getBytes() const { return bytes; }
+
+private:
+    struct Entry {
+        SDL_Texture* texture;
+        SDL_Renderer* renderer;
+        Uint32 format;
+        int access;
+        int width;
+        int height;
+        bool inUse;
+    };
+    std::vector<Entry> entries;
+    size_t bytes = 0;
+    static size_t entryBytes(const Entry& entry);
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <common.hpp>
+#include <texture_pool.hpp>
+
+/**
+ * @name TextureRing
+ * @author Hayden Beadles
+ * @brief A ring of one to three streaming textures with the same contents. Each frame writes the next
+ * texture in the ring while the GPU may still be reading the one drawn last frame, so the upload doesn't
+ * wait on it. Some drivers stall on that wait when the same texture is uploaded to every frame.
+ * The CPU buffer always holds the full image. Each texture keeps the damage from the frames it missed
+ * and gets it re-uploaded together with the current frame's rects.
+ * With a single texture this is the plain upload the maze did before.
+ */
+class TextureRing {
+
+public:
+    static constexpr int maxSlots = 3;
+    TextureRing() = default;
+    void acquire(TexturePool& pool, SDL_Renderer* renderer, Uint32 format, int width, int height, int slotCount);
+    void release(TexturePool& pool);
+    void setBlendMode(SDL_BlendMode mode);
+    void setScaleMode(SDL_ScaleMode mode);
+    SDL_Texture* upload(const Uint32* pixels, int pixelsWidth, int pixelsHeight,
+        const std::vector<SDL_Rect>& damage, UploadMethod method);
+    [[nodiscard]] SDL_Texture* front() const { return slotCount > 0 ? slots[current].texture : nullptr; }
+    [[nodiscard]] int getWidth() const { return width; }
+    [[nodiscard]] int getHeight() const { return height; }
+    [[nodiscard]] int getSlotCount() const { return slotCount; }
+    static void uploadRect(SDL_Texture* texture, const SDL_Rect& rect, const Uint32* pixels, int pixelsWidth,
+        UploadMethod method);
+
+private:
+    struct Slot {
+        SDL_Texture* texture;
+        std::vector<SDL_Rect> pending;  // Damage from frames that went to other textures
+        bool full;                      // Everything has to go up, the texture is new
+    };
+    Slot slots[maxSlots]{};
+    int slotCount = 0;
+    int current = 0;
+    int width = 0;
+    int height = 0;
+    static constexpr size_t maxPending = 64;    // Past this the pending rects collapse into their bounds
+};
+
+UploadMethod preferredUploadMethod(SDL_Renderer* renderer);
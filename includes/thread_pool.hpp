@@ -0,0 +1,41 @@
+#pragma once
+#include <common.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+ * @name ThreadPool
+ * @author Hayden Beadles
+ * @brief Persistent worker threads for splitting per-frame work (the raster bands) without spawning
+ * threads every frame. parallelFor hands out job indices from a shared counter, the calling thread
+ * takes jobs too and returns once every job is done.
+ * Web builds without pthreads get no workers and run everything on the calling thread.
+ */
+class ThreadPool {
+
+public:
+    explicit ThreadPool(int workerCount = defaultWorkerCount());
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    void parallelFor(int count, const std::function<void(int)>& job);
+    [[nodiscard]] int getThreadCount() const { return (int) workers.size() + 1; }
+    static int defaultWorkerCount();
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* currentJob = nullptr;
+    int jobCount = 0;
+    std::atomic<int> nextJob{0};
+    int activeWorkers = 0;
+    Uint64 generation = 0;
+    bool stopping = false;
+    void workerLoop();
+    void runJobs();
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <common.hpp>
+#include <texture_pool.hpp>
+#include <list>
+
+/**
+ * @name TileKey
+ * @brief One cache tile: level is the power of two zoom it was rasterized at, x and y its position in
+ * tiles at that zoom
+ * @struct TileKey
+ */
+struct TileKey {
+    int level;
+    int x;
+    int y;
+
+    bool operator==(const TileKey& other) const {
+        return level == other.level && x == other.x && y == other.y;
+    }
+};
+
+struct TileKeyHash {
+    size_t operator()(const TileKey& key) const {
+        size_t seed = std::hash<int>()(key.level);
+        seed ^= std::hash<int>()(key.x) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<int>()(key.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+};
+
+/**
+ * @name Tile
+ * @brief A cached tile texture. Stale tiles keep their texture and are re-rasterized in place.
+ * minDistance / maxDistance cover the visited cells in the tile, so a color LUT change only
+ * invalidates tiles that actually use the entries that moved.
+ * @struct Tile
+ */
+struct Tile {
+    TileKey key;
+    SDL_Texture* texture;
+    bool stale;
+    Uint32 minDistance;
+    Uint32 maxDistance;
+    Uint64 lastUsedFrame;
+};
+
+/**
+ * @name TileCache
+ * @author Hayden Beadles
+ * @brief LRU cache of fixed size maze tiles for the tiled render mode. Tiles are rasterized at a power
+ * of two zoom and scaled by the renderer for the zoom in between, so panning and most of a zoom are
+ * texture blits. A tile is re-rasterized only when a cell inside it changed or its colors moved.
+ * Textures come from the TexturePool; the least recently used tile hands its texture over once the
+ * VRAM budget is reached. Tiles on screen are never evicted, the budget stretches to hold one screen.
+ */
+class TileCache {
+
+public:
+    static constexpr int tileSize = 256;
+    static constexpr int minLevel = -10;
+    static constexpr int maxLevel = 4;     // Camera zooms up to 16x
+    TileCache() = default;
+    void setBudget(size_t bytes);
+    void beginFrame();
+    Tile* acquire(TexturePool& pool, SDL_Renderer* renderer, Uint32 format, const TileKey& key);
+    void invalidateCell(int cellX, int cellY, int cellSize);
+    void invalidateDistances(const std::vector<Uint32>& lut, const std::vector<Uint32>& previous);
+    void invalidateAll();
+    void releaseAll(TexturePool& pool);
+    void endFrame(TexturePool& pool);
+    [[nodiscard]] int getTileCount() const { return (int) tiles.size(); }
+    [[nodiscard]] size_t getBytes() const { return tiles.size() * tileBytes; }
+    [[nodiscard]] size_t getBudget() const { return budget; }
+    [[nodiscard]] double getHitRate() const { return hitRate; }
+    static int levelForZoom(double zoom);
+
+private:
+    static constexpr size_t tileBytes = (size_t) tileSize * tileSize * sizeof(Uint32);
+    std::list<Tile> tiles;      // Most recently used first
+    std::unordered_map<TileKey, std::list<Tile>::iterator, TileKeyHash> index;
+    int levelTiles[maxLevel - minLevel + 1]{};
+    std::vector<int> changedBefore;     // Prefix count of changed LUT entries
+    size_t budget = 64u << 20;
+    Uint64 frame = 0;
+    int frameHits = 0;
+    int frameLookups = 0;
+    double hitRate = 0.0;
+    void evict(std::list<Tile>::iterator tile, TexturePool& pool);
+};
@@ -3,9 +3,9 @@
 
 /**
  * @file utils.hpp
- * @brief Utility functions for maze calculations and color conversions.
+ * @brief Utility functions for color conversions and output file names.
  * @author Hayden Beadles
  */
-int calculateDistance(const MazeElement& elem1, const MazeElement& elem2);
-int calculateDistance(int x1, int y1, int x2, int y2);
-SDL_Color ImVec4ToSDLColor(const ImVec4& color);
\ No newline at end of file
+SDL_Color ImVec4ToSDLColor(const ImVec4& color);
+Uint32 mixColor(Uint32 from, Uint32 to, Uint32 weight);
+std::string numberedPath(const std::string& path, int index, int digits);
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <common.hpp>
+#include <camera.hpp>
+
+/**
+ * @name WallGeometry
+ * @author Hayden Beadles
+ * @brief The maze walls as a persistent triangle list for SDL_RenderGeometry. Walls are grouped by grid
+ * line: a cell row owns its north and south walls, a cell column its east and west walls. Runs of the
+ * same wall along a line are merged into one quad, so a long corridor side is a single quad.
+ * When a cell's walls change only its row and column are rebuilt. Their old quads are turned degenerate
+ * and the slots reused, so the buffer never has to be rebuilt as a whole.
+ * Only the rows and columns of the camera's viewport are built, in screen pixels, so a pan or zoom is a reset.
+ * Quads sit exactly where the CPU raster would have drawn the 1 pixel lines. They are rotated on the
+ * CPU around the screen center, and only when the angle changes.
+ */
+class WallGeometry {
+
+public:
+    WallGeometry() = default;
+    void reset(const CellViewport& view, int stride, SDL_Color color);
+    void markCell(int x, int y);
+    void rebuild(const Uint8* walls);
+    void draw(SDL_Renderer* renderer, float angle, SDL_FPoint center);
+    [[nodiscard]] int getQuadCount() const { return slotCount - (int) freeSlots.size(); }
+
+private:
+    CellViewport view{};
+    int stride = 0;             // Cells per grid row in the wall mask array
+    SDL_Color color{};
+    int slotCount = 0;
+    std::vector<SDL_FPoint> basePositions;  // Unrotated, 4 per slot
+    std::vector<SDL_Vertex> vertices;       // Rotated, what gets drawn
+    std::vector<int> indices;
+    std::vector<int> freeSlots;
+    std::vector<std::vector<int>> rowSlots;     // Indexed relative to the viewport, like the dirty flags
+    std::vector<std::vector<int>> columnSlots;
+    std::vector<Uint8> rowDirty;
+    std::vector<Uint8> columnDirty;
+    std::vector<int> dirtyRows;                 // Grid rows and columns
+    std::vector<int> dirtyColumns;
+    float rotatedAngle = 0.0f;
+    SDL_FPoint rotatedCenter{};
+    float angleSin = 0.0f;
+    float angleCos = 1.0f;
+    void rebuildRow(int y, const Uint8* walls);
+    void rebuildColumn(int x, const Uint8* walls);
+    void addQuad(std::vector<int>& owner, float x, float y, float w, float h);
+    void releaseSlots(std::vector<int>& owner);
+    void rotateSlot(int slot);
+};
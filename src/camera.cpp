@@ -0,0 +1,112 @@
+#include <camera.hpp>
+
+/**
+ * @name reset
+ * @brief Back to 1:1 with the maze's top left corner at the top left of the window
+ * @memberof Camera
+ */
+void Camera::reset(){
+    zoom = 1.0;
+    offsetX = 0.0;
+    offsetY = 0.0;
+}
+
+/**
+ * @name fit
+ * @brief Zooms so the whole maze fits the window and centers it. Never zooms in past 1:1.
+ * @param worldWidth, worldHeight - maze size in pixels
+ * @param screenWidth, screenHeight - window size in pixels
+ * @memberof Camera
+ */
+void Camera::fit(double worldWidth, double worldHeight, int screenWidth, int screenHeight){
+    if (worldWidth <= 0 || worldHeight <= 0) {
+        reset();
+        return;
+    }
+    zoom = std::clamp(std::min(screenWidth / worldWidth, screenHeight / worldHeight), minZoom, 1.0);
+    offsetX = (worldWidth - screenWidth / zoom) / 2.0;
+    offsetY = (worldHeight - screenHeight / zoom) / 2.0;
+}
+
+/**
+ * @name zoomAt
+ * @brief Zooms by factor, keeping the world point under (screenX, screenY) in place, so the wheel
+ * zooms toward the mouse
+ * @param factor - > 1 zooms in
+ * @param screenX, screenY - anchor in window pixels
+ * @memberof Camera
+ */
+void Camera::zoomAt(double factor, double screenX, double screenY){
+    double worldX = offsetX + screenX / zoom;
+    double worldY = offsetY + screenY / zoom;
+    zoom = std::clamp(zoom * factor, minZoom, maxZoom);
+    offsetX = worldX - screenX / zoom;
+    offsetY = worldY - screenY / zoom;
+}
+
+/**
+ * @name pan
+ * @brief Moves the view along with a drag, in window pixels
+ * @param screenDX, screenDY - how far the content moved on screen
+ * @memberof Camera
+ */
+void Camera::pan(double screenDX, double screenDY){
+    offsetX -= screenDX / zoom;
+    offsetY -= screenDY / zoom;
+}
+
+/**
+ * @name clamp
+ * @brief Keeps at least half the window over the maze, so it can't be lost off screen
+ * @param worldWidth, worldHeight - maze size in pixels
+ * @param screenWidth, screenHeight - window size in pixels
+ * @memberof Camera
+ */
+void Camera::clamp(double worldWidth, double worldHeight, int screenWidth, int screenHeight){
+    double halfW = screenWidth / zoom / 2.0;
+    double halfH = screenHeight / zoom / 2.0;
+    offsetX = std::clamp(offsetX, -halfW, std::max(-halfW, worldWidth - halfW));
+    offsetY = std::clamp(offsetY, -halfH, std::max(-halfH, worldHeight - halfH));
+}
+
+/**
+ * @name viewport
+ * @brief The cells visible this frame. Offsets are snapped to whole screen pixels so the cell edges
+ * don't shimmer while panning.
+ * @param cellSize - pixels per cell at zoom 1
+ * @param cellsX, cellsY - grid size
+ * @param screenWidth, screenHeight - window size in pixels
+ * @return CellViewport
+ * @memberof Camera
+ */
+CellViewport Camera::viewport(int cellSize, int cellsX, int cellsY, int screenWidth, int screenHeight) const{
+    return CellViewport::covering(cellSize, zoom, std::round(offsetX * zoom) / zoom, std::round(offsetY * zoom) / zoom,
+        cellsX, cellsY, screenWidth, screenHeight);
+}
+
+/**
+ * @name covering
+ * @brief The cells that land in a width x height pixel area, given where its top left corner is in the
+ * world and the zoom. Used for the screen and for the cache tiles.
+ * @param cellSize - pixels per cell at zoom 1
+ * @param zoom - screen pixels per world pixel
+ * @param offsetX, offsetY - world pixel at the area's top left corner
+ * @param cellsX, cellsY - grid size
+ * @param width, height - area size in pixels
+ * @return CellViewport
+ * @memberof CellViewport
+ */
+CellViewport CellViewport::covering(int cellSize, double zoom, double offsetX, double offsetY,
+    int cellsX, int cellsY, int width, int height){
+    CellViewport view{};
+    view.cellSize = cellSize;
+    view.zoom = zoom;
+    view.offsetX = offsetX;
+    view.offsetY = offsetY;
+    double cellScreen = cellSize * zoom;
+    view.x0 = std::clamp((int) std::floor(offsetX / cellSize), 0, cellsX);
+    view.y0 = std::clamp((int) std::floor(offsetY / cellSize), 0, cellsY);
+    view.x1 = std::clamp((int) std::ceil((offsetX * zoom + width) / cellScreen), view.x0, cellsX);
+    view.y1 = std::clamp((int) std::ceil((offsetY * zoom + height) / cellScreen), view.y0, cellsY);
+    return view;
+}
@@ -0,0 +1,319 @@
+#include <frame_capture.hpp>
+#include <utils.hpp>
+#include <csignal>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+/**
+ * @name FrameCapture Destructor
+ * @brief Finishes writing whatever is queued
+ * @memberof FrameCapture
+ */
+FrameCapture::~FrameCapture(){
+    stop();
+}
+
+/**
+ * @name isSupported
+ * @brief Capturing needs worker threads
+ * @return bool
+ * @memberof FrameCapture
+ */
+bool FrameCapture::isSupported(){
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+/**
+ * @name start
+ * @brief Opens the output and starts the workers. The buffers are sized by the first frame each one
+ * holds, so the pool costs nothing until frames come in.
+ * @param settings - clamped to sane values
+ * @param layout - PixelLayout the submitted frames are in
+ * @return bool - false if already capturing, capture isn't supported, or the raw output can't be opened
+ * @memberof FrameCapture
+ */
+bool FrameCapture::start(const CaptureSettings& settings, PixelLayout layout){
+    if (active || !isSupported()) {
+        return false;
+    }
+    this->settings = settings;
+    this->settings.every = std::max(settings.every, 1);
+    this->settings.bufferCount = std::clamp(settings.bufferCount, 2, 64);
+    this->settings.workerCount = std::clamp(settings.workerCount, 1, 8);
+    this->layout = layout;
+
+    if (this->settings.format == CAPTURE_RAW) {
+        if (this->settings.output == "-") {
+            stream = stdout;
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        } else {
+            stream = fopen(this->settings.output.c_str(), "wb");
+        }
+        if (!stream) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not open %s for capture",
+                this->settings.output.c_str());
+            return false;
+        }
+#ifdef SIGPIPE
+        // An encoder that exits early should end the capture, not the program. Only while capturing,
+        // stop puts the previous handler back
+        previousSigpipe = signal(SIGPIPE, SIG_IGN);
+        sigpipeIgnored = previousSigpipe != SIG_ERR;
+#endif
+    }
+
+    buffers.assign(this->settings.bufferCount, Buffer{});
+    freeBuffers.clear();
+    for (int i = this->settings.bufferCount - 1; i >= 0; i--) {
+        freeBuffers.push_back(i);
+    }
+    queue.clear();
+    stopping = false;
+    offeredFrames = 0;
+    nextSequence = 0;
+    nextWrite = 0;
+    streamWidth = 0;
+    streamHeight = 0;
+    queuedFrames = 0;
+    writtenFrames = 0;
+    droppedFrames = 0;
+    failedFrames = 0;
+    for (int i = 0; i < this->settings.workerCount; i++) {
+        workers.emplace_back(&FrameCapture::workerLoop, this);
+    }
+    active = true;
+    return true;
+}
+
+/**
+ * @name stop
+ * @brief Lets the workers write out the queue, joins them, closes the output and restores the SIGPIPE
+ * handler. The counters stay readable until the next start.
+ * @memberof FrameCapture
+ */
+void FrameCapture::stop(){
+    if (!active) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    if (stream) {
+        fflush(stream);
+        if (stream != stdout) {
+            fclose(stream);
+        }
+        stream = nullptr;
+    }
+#ifdef SIGPIPE
+    if (sigpipeIgnored) {
+        signal(SIGPIPE, previousSigpipe);
+        sigpipeIgnored = false;
+    }
+#endif
+    buffers.clear();
+    buffers.shrink_to_fit();
+    freeBuffers.clear();
+    active = false;
+    SDL_Log("Capture stopped: %llu frames written, %llu dropped, %llu failed",
+        (unsigned long long) writtenFrames, (unsigned long long) droppedFrames,
+        (unsigned long long) failedFrames);
+}
+
+/**
+ * @name submit
+ * @brief Offers a drawn frame. Every Nth one is copied into a free buffer and queued for the workers;
+ * with no buffer free it is dropped. The copy is all the main loop pays, it never waits on a worker.
+ * @param pixels - frame in the layout given to start, width per row
+ * @param width, height
+ * @memberof FrameCapture
+ */
+void FrameCapture::submit(const Uint32* pixels, int width, int height){
+    if (!active || offeredFrames++ % settings.every != 0) {
+        return;
+    }
+    if (settings.format == CAPTURE_RAW) {
+        if (streamWidth == 0) {
+            streamWidth = width;
+            streamHeight = height;
+            SDL_Log("Capturing %dx%d RGBA frames to %s", width, height,
+                stream == stdout ? "stdout" : settings.output.c_str());
+        } else if (width != streamWidth || height != streamHeight) {
+            droppedFrames++;
+            return;
+        }
+    }
+
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeBuffers.empty()) {
+            droppedFrames++;
+            return;
+        }
+        index = freeBuffers.back();
+        freeBuffers.pop_back();
+    }
+    // Nobody else touches a buffer between taking it off the free list and queuing it
+    Buffer& buffer = buffers[index];
+    buffer.pixels.assign(pixels, pixels + (size_t) width * height);
+    buffer.width = width;
+    buffer.height = height;
+    buffer.sequence = nextSequence++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(index);
+    }
+    work.notify_one();
+    queuedFrames++;
+}
+
+/**
+ * @name getBuffersInUse
+ * @brief Buffers queued or being written
+ * @return int
+ * @memberof FrameCapture
+ */
+int FrameCapture::getBuffersInUse(){
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int) (buffers.size() - freeBuffers.size());
+}
+
+/**
+ * @name workerLoop
+ * @brief Takes queued frames, writes them and frees their buffers. Exits once stopping and the queue
+ * is empty.
+ * @memberof FrameCapture
+ */
+void FrameCapture::workerLoop(){
+    std::vector<Uint32> converted;
+    while (true) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            work.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            index = queue.front();
+            queue.pop_front();
+        }
+        const Buffer& buffer = buffers[index];
+        bool written = settings.format == CAPTURE_RAW ? writeRaw(buffer, converted) : writePng(buffer);
+        (written ? writtenFrames : failedFrames)++;
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(index);
+    }
+}
+
+/**
+ * @name writePng
+ * @brief Saves a frame as the next numbered PNG
+ * @param buffer
+ * @return bool - true if written
+ * @memberof FrameCapture
+ */
+bool FrameCapture::writePng(const Buffer& buffer){
+    std::string path = numberedPath(settings.output, (int) buffer.sequence + 1, 6);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom((void*) buffer.pixels.data(), buffer.width,
+        buffer.height, 32, buffer.width * (int) sizeof(Uint32), pixelFormatFor(layout));
+    if (!surface) {
+        return false;
+    }
+    int result = IMG_SavePNG(surface, path.c_str());
+    SDL_FreeSurface(surface);
+    if (result != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not save %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @name writeRaw
+ * @brief Converts a frame to RGBA bytes, then waits for the frames before it to be written and
+ * appends it to the stream. Conversion runs in parallel across workers, only the write is in order.
+ * @param buffer
+ * @param converted - the worker's scratch frame
+ * @return bool - true if the whole frame was written
+ * @memberof FrameCapture
+ */
+bool FrameCapture::writeRaw(const Buffer& buffer, std::vector<Uint32>& converted){
+    const Uint32* pixels = buffer.pixels.data();
+    int pitch = buffer.width * (int) sizeof(Uint32);
+    Uint32 format = pixelFormatFor(layout);
+    if (format != SDL_PIXELFORMAT_RGBA32) {
+        converted.resize(buffer.pixels.size());
+        SDL_ConvertPixels(buffer.width, buffer.height, format, pixels, pitch, SDL_PIXELFORMAT_RGBA32,
+            converted.data(), pitch);
+        pixels = converted.data();
+    }
+
+    std::unique_lock<std::mutex> lock(streamMutex);
+    turn.wait(lock, [this, &buffer] { return nextWrite == buffer.sequence; });
+    size_t count = buffer.pixels.size();
+    bool written = fwrite(pixels, sizeof(Uint32), count, stream) == count;
+    nextWrite++;
+    turn.notify_all();
+    return written;
+}
+
+/**
+ * @name parseCaptureArgs
+ * @brief Reads the capture options of a windowed run, --capture starts capturing at launch.
+ * Everything else on the command line is left alone.
+ *   --capture png|raw       numbered PNGs, or raw RGBA frames
+ *   --capture-every N       keep every Nth drawn frame
+ *   --capture-out PATH      PNG name to number, or raw file, "-" for stdout
+ *   --capture-buffers N     frames that may wait for the workers
+ *   --capture-workers N     encoding threads
+ * @param argc, argv - command line
+ * @param settings - out
+ * @return bool - true if --capture was given
+ */
+bool parseCaptureArgs(int argc, char** argv, CaptureSettings& settings){
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = argv[i + 1];
+        bool ok = true;
+        if (arg == "--capture") {
+            settings.startOnLaunch = true;
+            if (SDL_strcasecmp(value, "raw") == 0) {
+                settings.format = CAPTURE_RAW;
+                settings.output = settings.output == "frame.png" ? "-" : settings.output;
+            } else {
+                ok = SDL_strcasecmp(value, "png") == 0;
+            }
+        } else if (arg == "--capture-every") {
+            ok = sscanf(value, "%d", &settings.every) == 1;
+        } else if (arg == "--capture-out") {
+            settings.output = value;
+        } else if (arg == "--capture-buffers") {
+            ok = sscanf(value, "%d", &settings.bufferCount) == 1;
+        } else if (arg == "--capture-workers") {
+            ok = sscanf(value, "%d", &settings.workerCount) == 1;
+        } else {
+            continue;
+        }
+        if (!ok) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Ignoring %s %s", arg.c_str(), value);
+        }
+        i++;
+    }
+    return settings.startOnLaunch;
+}
@@ -0,0 +1,160 @@
+#include <frame_scheduler.hpp>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX    // Keep std::min / std::max usable
+#endif
+#include <windows.h>
+#endif
+
+/**
+ * @name FrameScheduler Constructor
+ * @param targetFps - frame rate when sleeping paces the loop
+ * @param stepMs - simulated time per generation step
+ * @memberof FrameScheduler
+ */
+FrameScheduler::FrameScheduler(double targetFps, double stepMs)
+: frequency(SDL_GetPerformanceFrequency()), targetMs(1000.0 / targetFps), stepMs(stepMs) {
+}
+
+/**
+ * @name configure
+ * @brief Checks whether the renderer presents with vsync. If it claims to, present is trusted to pace
+ * the loop until frames turn out too fast for that to be true.
+ * @param renderer
+ * @memberof FrameScheduler
+ */
+void FrameScheduler::configure(SDL_Renderer* renderer){
+    SDL_RendererInfo info{};
+    vsyncPacing = renderer && SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    fastFrames = 0;
+    lastFrameStart = SDL_GetPerformanceCounter();
+    deadline = lastFrameStart;
+    cpuSampleStart = lastFrameStart;
+    cpuSeconds = processCpuSeconds();
+}
+
+/**
+ * @name waitForNextFrame
+ * @brief Called at the top of every frame. Sleeps until the frame deadline unless vsync paces the loop,
+ * then measures the frame and feeds it to the step accumulator.
+ * @memberof FrameScheduler
+ */
+void FrameScheduler::waitForNextFrame(){
+#ifndef __EMSCRIPTEN__
+    if (!vsyncPacing) {
+        Uint64 targetTicks = (Uint64) (targetMs * (double) frequency / 1000.0);
+        deadline += targetTicks;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now > deadline + targetTicks) {
+            // More than a frame behind (a stall, a huge instant maze), don't try to catch up
+            deadline = now;
+        }
+        double remaining = now < deadline ? toMs(deadline - now) : 0.0;
+        if (remaining > oversleepMs) {
+            Uint32 request = (Uint32) (remaining - oversleepMs);
+            Uint64 before = SDL_GetPerformanceCounter();
+            SDL_Delay(request);
+            double late = toMs(SDL_GetPerformanceCounter() - before) - request;
+            oversleepMs = std::clamp(oversleepMs * 0.9 + late * 0.1, 0.0, 4.0);
+        }
+    }
+#endif
+    Uint64 now = SDL_GetPerformanceCounter();
+    frameMs = toMs(now - lastFrameStart);
+    lastFrameStart = now;
+    // A frame that waited for events didn't present, vsync had no say in how long it took
+    if (vsyncPacing && idleTicks == 0) {
+        fastFrames = frameMs < vsyncMinFrameMs ? fastFrames + 1 : 0;
+        if (fastFrames > 30) {
+            vsyncPacing = false;
+            deadline = now;
+        }
+    }
+    // The wait itself went to the simulation in waitForEvent
+    accumulatorMs += std::min(std::max(frameMs - toMs(idleTicks), 0.0), 250.0);
+    idleTicks = 0;
+    stepsThisFrame = 0;
+    sampleCpu(now);
+}
+
+/**
+ * @name nextStep
+ * @brief Hands out the next due simulation step, call in a loop until it returns false
+ * @param simulationTime - out, simulated time of the step in milliseconds
+ * @return bool - false once the accumulator is drained or the per-frame cap is hit
+ * @memberof FrameScheduler
+ */
+bool FrameScheduler::nextStep(Uint32& simulationTime){
+    if (accumulatorMs < stepMs) {
+        return false;
+    }
+    if (stepsThisFrame == maxStepsPerFrame) {
+        accumulatorMs = std::fmod(accumulatorMs, stepMs);
+        return false;
+    }
+    accumulatorMs -= stepMs;
+    simulationMs += stepMs;
+    stepsThisFrame++;
+    simulationTime = (Uint32) simulationMs;
+    return true;
+}
+
+/**
+ * @name waitForEvent
+ * @brief Blocks until an event arrives or the timeout runs out, for frames where nothing would change.
+ * Nothing happens in the simulation before the timeout either, so its clock is moved over the whole wait
+ * instead of stepping through it at maxStepsPerFrame a frame.
+ * @param event - out, the event received
+ * @param timeoutMs - longest wait, -1 waits for input however long it takes
+ * @return bool - true if an event was received
+ * @memberof FrameScheduler
+ */
+bool FrameScheduler::waitForEvent(SDL_Event& event, int timeoutMs){
+    Uint64 before = SDL_GetPerformanceCounter();
+    bool received = SDL_WaitEventTimeout(&event, timeoutMs) != 0;
+    Uint64 waited = SDL_GetPerformanceCounter() - before;
+    idleTicks += waited;
+    simulationMs += toMs(waited);
+    return received;
+}
+
+/**
+ * @name sampleCpu
+ * @brief Every half second, CPU time used by the process (all threads) over the wall time passed.
+ * 1.0 is one core fully busy.
+ * @param now - performance counter
+ * @memberof FrameScheduler
+ */
+void FrameScheduler::sampleCpu(Uint64 now){
+    double wall = toMs(now - cpuSampleStart) / 1000.0;
+    if (wall < 0.5) {
+        return;
+    }
+    double cpu = processCpuSeconds();
+    cpuUtilization = (cpu - cpuSeconds) / wall;
+    cpuSeconds = cpu;
+    cpuSampleStart = now;
+}
+
+/**
+ * @name processCpuSeconds
+ * @brief CPU time the process has used so far. std::clock is wall time on Windows, so ask the OS there.
+ * @return double - seconds
+ * @memberof FrameScheduler
+ */
+double FrameScheduler::processCpuSeconds(){
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    ULARGE_INTEGER kernelTime{}, userTime{};
+    kernelTime.LowPart = kernel.dwLowDateTime;
+    kernelTime.HighPart = kernel.dwHighDateTime;
+    userTime.LowPart = user.dwLowDateTime;
+    userTime.HighPart = user.dwHighDateTime;
+    return (double) (kernelTime.QuadPart + userTime.QuadPart) / 1e7;
+#else
+    return (double) std::clock() / CLOCKS_PER_SEC;
+#endif
+}
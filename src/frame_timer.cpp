@@ -0,0 +1,64 @@
+#include <frame_timer.hpp>
+
+/**
+ * @name FrameTimer Constructor
+ * @memberof FrameTimer
+ */
+FrameTimer::FrameTimer(){
+    frequency = SDL_GetPerformanceFrequency();
+}
+
+/**
+ * @name begin
+ * @brief Starts timing a phase
+ * @param phase
+ * @memberof FrameTimer
+ */
+void FrameTimer::begin(FramePhase phase){
+    started[phase] = SDL_GetPerformanceCounter();
+}
+
+/**
+ * @name end
+ * @brief Adds the time since the matching begin to this frame's total for the phase
+ * @param phase
+ * @memberof FrameTimer
+ */
+void FrameTimer::end(FramePhase phase){
+    Uint64 elapsed = SDL_GetPerformanceCounter() - started[phase];
+    frameMs[phase] += (double) elapsed * 1000.0 / (double) frequency;
+}
+
+/**
+ * @name endFrame
+ * @brief Folds this frame's totals into the smoothed averages and starts a new frame
+ * @memberof FrameTimer
+ */
+void FrameTimer::endFrame(){
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        smoothedMs[i] += (frameMs[i] - smoothedMs[i]) * smoothing;
+        frameMs[i] = 0.0;
+    }
+}
+
+/**
+ * @name phaseName
+ * @brief Label for the UI
+ * @param phase
+ * @return const char*
+ * @memberof FrameTimer
+ */
+const char* FrameTimer::phaseName(FramePhase phase){
+    switch (phase) {
+        case PHASE_UPDATE:
+            return "Update";
+        case PHASE_RASTER:
+            return "Raster";
+        case PHASE_UPLOAD:
+            return "Upload";
+        case PHASE_PRESENT:
+            return "Present";
+        default:
+            return "";
+    }
+}
@@ -5,6 +5,7 @@ Game::Game(Application &app){
     std::srand(std::time(nullptr));  // Initialize random seed
     app.screenHeight = SCREEN_HEIGHT;
     app.screenWidth = SCREEN_WIDTH;
+    app.pixelScale = 1.0f;
     this->app = app;
     this->mIsRunning = true;
     this->mTicksCount = 0;
@@ -26,12 +27,128 @@ bool Game::initialize(const std::string& title){
             5,
             10
         };
+        renderConfig.uploadMethod = preferredUploadMethod(app.renderer);
         currentStateConfig = renderConfig;
+        pixelLayout = negotiatePixelLayout(app.renderer);
         mazeComplexObject = MazeComplex(this, &colorConfig);
+        scheduler.configure(app.renderer);
+        if (captureSettings.startOnLaunch) {
+            startCapture();
+        }
     }
     return init;
 };
 
+/**
+ * @name initializeHeadless
+ * @brief Sets up the maze without SDL video, a window, a renderer or ImGui, for batch rendering and
+ * benchmarks. Rasterizing is the same code as on screen, in pixel mode with CPU walls so the finished
+ * image ends up in the maze's framebuffer. Nothing is generated until the caller asks for it.
+ * @param width, height - image size in pixels
+ * @param config - maze settings, the render mode and wall drawing are overridden
+ * @return bool - false for an empty image
+ * @memberof Game
+ */
+bool Game::initializeHeadless(int width, int height, const MazeRenderConfig& config){
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    app.window = nullptr;
+    app.renderer = nullptr;
+    app.io = nullptr;
+    app.screenWidth = width;
+    app.screenHeight = height;
+    app.pixelScale = 1.0f;
+    colorConfig = {
+        ImVec4(114.0 / 255.0, 36.0 / 255.0, 72.0 / 255.0, 1.0f),
+        ImVec4(64.0 / 255.0, 178.0 / 255.0, 88.0 / 255.0, 1.0f),
+        ImVec4(85.0 / 255.0, 128.0 / 255.0, 1.0 / 255.0, 1.0f),
+        true
+    };
+    renderConfig = config;
+    renderConfig.renderMode = RENDER_PIXEL;
+    renderConfig.gpuWalls = false;
+    currentStateConfig = renderConfig;
+    pixelLayout = LAYOUT_ARGB;
+    mazeComplexObject = MazeComplex(this, &colorConfig);
+    return true;
+}
+
+/**
+ * @name generateHeadless
+ * @brief Generates a complete maze with the current config. The camera starts at 1:1, or zoomed out to
+ * fit when the grid is bigger than the image.
+ * @memberof Game
+ */
+void Game::generateHeadless(){
+    mazeComplexObject.configureRooms(renderConfig.roomLayout());
+    mazeComplexObject.resetMazeComplex();
+    mazeComplexObject.initMazeComplex();
+    mazeComplexObject.generateCompleteMaze();
+    camera.reset();
+    if (mazeComplexObject.getWorldWidth() > app.screenWidth || mazeComplexObject.getWorldHeight() > app.screenHeight) {
+        camera.fit(mazeComplexObject.getWorldWidth(), mazeComplexObject.getWorldHeight(),
+            app.screenWidth, app.screenHeight);
+    }
+}
+
+/**
+ * @name drawHeadless
+ * @brief Rasterizes the maze into its framebuffer, only what changed since the last call
+ * @param time - color wave time in milliseconds
+ * @memberof Game
+ */
+void Game::drawHeadless(Uint32 time){
+    mazeComplexObject.displayMazeComplex(time);
+}
+
+/**
+ * @name saveFrame
+ * @brief Writes the maze's framebuffer to an image, PNG for a .png path and BMP otherwise.
+ * Needs no video subsystem, only a surface wrapped around the pixels.
+ * @param path - file to write
+ * @return bool - true on success
+ * @memberof Game
+ */
+bool Game::saveFrame(const std::string& path){
+    const std::vector<Uint32>& pixels = mazeComplexObject.getFramebuffer();
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom((void*) pixels.data(), app.screenWidth,
+        app.screenHeight, 32, app.screenWidth * (int) sizeof(Uint32), pixelFormatFor(pixelLayout));
+    if (!surface) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not wrap the framebuffer: %s", SDL_GetError());
+        return false;
+    }
+    bool png = path.size() >= 4 && SDL_strcasecmp(path.c_str() + path.size() - 4, ".png") == 0;
+    int result = png ? IMG_SavePNG(surface, path.c_str()) : SDL_SaveBMP(surface, path.c_str());
+    SDL_FreeSurface(surface);
+    if (result != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not save %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @name startCapture
+ * @brief Starts recording drawn frames. Only the pixel mode framebuffer with CPU walls holds the whole
+ * picture, so the maze switches to that first; the switch lands before the next frame is drawn.
+ * @memberof Game
+ */
+void Game::startCapture(){
+    currentStateConfig.renderMode = RENDER_PIXEL;
+    currentStateConfig.gpuWalls = false;
+    capture.start(captureSettings, pixelLayout);
+}
+
+/**
+ * @name isCaptureSource
+ * @brief Whether the framebuffer holds the frame as drawn, see startCapture
+ * @return bool
+ * @memberof Game
+ */
+bool Game::isCaptureSource() const{
+    return renderConfig.renderMode == RENDER_PIXEL && !renderConfig.gpuWalls;
+}
 
 void Game::runloop(){
     while(mIsRunning){
@@ -44,7 +161,21 @@ void Game::runloop(){
 void Game::processInput() {
 
     SDL_Event event;
-    while(SDL_PollEvent(&event)){
+    bool pending;
+#ifdef __EMSCRIPTEN__
+    pending = SDL_PollEvent(&event);
+#else
+    // Nothing changed last frame, sleep until input arrives or the maze is due to change by itself
+    if (idle) {
+        pending = scheduler.waitForEvent(event,
+            mazeComplexObject.getIdleTimeout(scheduler.getSimulationTime()));
+    } else {
+        pending = SDL_PollEvent(&event);
+    }
+#endif
+    for (; pending; pending = SDL_PollEvent(&event)) {
+        // ImGui can take a few frames to settle after input (hover, layout, popups)
+        activeFrames = settleFrames;
         ImGui_ImplSDL2_ProcessEvent(&event);
 
         switch(event.type){
@@ -56,19 +187,37 @@ void Game::processInput() {
                 break;
             case SDL_WINDOWEVENT:
                 switch (event.window.event) {
-                    case SDL_WINDOWEVENT_RESIZED:
-                    app.screenWidth = event.window.data1;
-                    app.screenHeight = event.window.data2;
-                    mazeComplexObject.resetMazeComplex();
-                    mazeComplexObject.initMazeComplex();
+                    // The event sizes are in window units, ask the renderer for pixels. Moving to a
+                    // display with another scale changes the pixels without resizing the window
+                    case SDL_WINDOWEVENT_SIZE_CHANGED:
+                    case SDL_WINDOWEVENT_DISPLAY_CHANGED:
+                    if (updateOutputSize(app)) {
+                        mazeComplexObject.resetMazeComplex();
+                        mazeComplexObject.initMazeComplex();
+                        clampCamera();
+                    }
                     break;
                 default: ;
                 }
-            default: ;
+                break;
+            default:
+                processCameraInput(event);
         }
     }
 
     const Uint8* state = SDL_GetKeyboardState(nullptr);
+    // Held arrow keys / WASD pan smoothly rather than at the key repeat rate
+    if (!app.io->WantCaptureKeyboard) {
+        float step = 600.0f * app.pixelScale * (float) app.deltaTime;
+        float dx = (float) (state[SDL_SCANCODE_LEFT] || state[SDL_SCANCODE_A]) -
+            (float) (state[SDL_SCANCODE_RIGHT] || state[SDL_SCANCODE_D]);
+        float dy = (float) (state[SDL_SCANCODE_UP] || state[SDL_SCANCODE_W]) -
+            (float) (state[SDL_SCANCODE_DOWN] || state[SDL_SCANCODE_S]);
+        if (dx != 0.0f || dy != 0.0f) {
+            camera.pan(dx * step, dy * step);
+            clampCamera();
+        }
+    }
 
     if (state[SDL_SCANCODE_ESCAPE]){
         mIsRunning = false;
@@ -78,6 +227,71 @@ void Game::processInput() {
     }
 };
 
+/**
+ * @name processCameraInput
+ * @brief Mouse and keyboard control of the camera, skipped while ImGui wants the input.
+ * Wheel zooms toward the mouse, dragging with any button pans, +/- zoom around the window center,
+ * Home fits the whole maze in the window and 0 goes back to 1:1.
+ * @param event
+ * @memberof Game
+ */
+void Game::processCameraInput(const SDL_Event& event){
+    switch (event.type) {
+        case SDL_MOUSEWHEEL:
+            if (app.io->WantCaptureMouse) {
+                return;
+            }
+            int mouseX, mouseY;
+            SDL_GetMouseState(&mouseX, &mouseY);
+            // Mouse positions are in window units, the camera works in output pixels
+            camera.zoomAt(std::pow(1.1, event.wheel.preciseY), mouseX * app.pixelScale, mouseY * app.pixelScale);
+            break;
+        case SDL_MOUSEMOTION:
+            if (app.io->WantCaptureMouse || event.motion.state == 0) {
+                return;
+            }
+            camera.pan(event.motion.xrel * app.pixelScale, event.motion.yrel * app.pixelScale);
+            break;
+        case SDL_KEYDOWN:
+            if (app.io->WantCaptureKeyboard) {
+                return;
+            }
+            switch (event.key.keysym.sym) {
+                case SDLK_EQUALS:
+                case SDLK_KP_PLUS:
+                    camera.zoomAt(1.25, app.screenWidth / 2.0, app.screenHeight / 2.0);
+                    break;
+                case SDLK_MINUS:
+                case SDLK_KP_MINUS:
+                    camera.zoomAt(0.8, app.screenWidth / 2.0, app.screenHeight / 2.0);
+                    break;
+                case SDLK_HOME:
+                    camera.fit(mazeComplexObject.getWorldWidth(), mazeComplexObject.getWorldHeight(),
+                        app.screenWidth, app.screenHeight);
+                    break;
+                case SDLK_0:
+                    camera.reset();
+                    break;
+                default:
+                    return;
+            }
+            break;
+        default:
+            return;
+    }
+    clampCamera();
+}
+
+/**
+ * @name clampCamera
+ * @brief Keeps the maze on screen after the camera or the maze size changed
+ * @memberof Game
+ */
+void Game::clampCamera(){
+    camera.clamp(mazeComplexObject.getWorldWidth(), mazeComplexObject.getWorldHeight(),
+        app.screenWidth, app.screenHeight);
+}
+
 void Game::renderUI(bool *openFlag){
 
     static ImGuiColorEditFlags base_flags = ImGuiColorEditFlags_None;
@@ -111,69 +325,234 @@ void Game::renderUI(bool *openFlag){
     ImGui::SeparatorText("Maze Settings");
     ImGui::Checkbox("Render maze step by step?", &currentStateConfig.renderByFrame);
     ImGui::SliderInt("Cell size", &currentStateConfig.pixelSize, 10, 30);
+    static const char* renderModeNames[] = {"Pixels (CPU)", "Cells (GPU upscale)", "Tiles (cached)"};
+    int renderMode = currentStateConfig.renderMode;
+    if (ImGui::Combo("Render Mode", &renderMode, renderModeNames, IM_ARRAYSIZE(renderModeNames))) {
+        currentStateConfig.renderMode = (RenderMode) renderMode;
+    }
+    if (currentStateConfig.renderMode == RENDER_TILED) {
+        ImGui::SliderInt("Tile budget (MB)", &currentStateConfig.tileBudgetMB, 8, 1024, "%d", ImGuiSliderFlags_Logarithmic);
+    } else {
+        ImGui::Checkbox("Draw walls on the GPU", &currentStateConfig.gpuWalls);
+    }
+    ImGui::InputInt("Grid Width (0 = window)", &currentStateConfig.gridWidth, 100, 1000);
+    ImGui::InputInt("Grid Height (0 = window)", &currentStateConfig.gridHeight, 100, 1000);
+    currentStateConfig.gridWidth = std::clamp(currentStateConfig.gridWidth, 0, MazeRenderConfig::maxGridCells);
+    currentStateConfig.gridHeight = std::clamp(currentStateConfig.gridHeight, 0, MazeRenderConfig::maxGridCells);
+    if ((long long) std::max(currentStateConfig.gridWidth, 1) * std::max(currentStateConfig.gridHeight, 1) >
+        MazeRenderConfig::maxGridCells) {
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Over %d cells, the height will be cut down",
+            MazeRenderConfig::maxGridCells);
+    }
+    ImGui::Text("Grid %d x %d, zoom %.3fx, %d cells visible", mazeComplexObject.getGridWidth(),
+        mazeComplexObject.getGridHeight(), camera.getZoom(), mazeComplexObject.getVisibleCells());
+    ImGui::TextDisabled("Wheel/+/- zoom, drag or arrows/WASD pan, Home fits, 0 resets");
     ImGui::SeparatorText("Room Settings");
-    ImGui::SliderInt("Number of Rooms", &currentStateConfig.numRooms, 1, 10);
-
-    if (uiRoomWidth < 2) uiRoomWidth = 2;
-    if (uiRoomWidth > 20) uiRoomWidth = 20;
-    if (uiRoomHeight < 2) uiRoomHeight = 2;
-    if (uiRoomHeight > 20) uiRoomHeight = 20;
+    ImGui::SliderInt("Number of Rooms", &currentStateConfig.numRooms, 0, 50000, "%d", ImGuiSliderFlags_Logarithmic);
+    static const char* packingNames[] = {"Random", "Skyline", "Guillotine"};
+    int packing = currentStateConfig.roomPacking;
+    if (ImGui::Combo("Packing", &packing, packingNames, IM_ARRAYSIZE(packingNames))) {
+        currentStateConfig.roomPacking = (RoomPacking) packing;
+    }
+    static const char* distributionNames[] = {"Fixed", "Uniform", "Mostly small"};
+    int distribution = currentStateConfig.roomDistribution;
+    if (ImGui::Combo("Room Sizes", &distribution, distributionNames, IM_ARRAYSIZE(distributionNames))) {
+        currentStateConfig.roomDistribution = (RoomSizeDistribution) distribution;
+    }
 
     ImGui::InputInt("Room Width", &currentStateConfig.roomWidth);
     ImGui::InputInt("Room Height", &currentStateConfig.roomHeight);
-
-    if (!(currentStateConfig == renderConfig)) {
-        renderConfig = currentStateConfig;
-        uiNumRooms = renderConfig.numRooms;
-        uiRoomWidth = renderConfig.roomWidth;
-        uiRoomHeight = renderConfig.roomHeight;
-        uiParamsChanged = true;
+    if (currentStateConfig.roomDistribution != SIZE_FIXED) {
+        ImGui::InputInt("Room Max Width", &currentStateConfig.roomMaxWidth);
+        ImGui::InputInt("Room Max Height", &currentStateConfig.roomMaxHeight);
     }
+    ImGui::SliderInt("Room Spacing", &currentStateConfig.roomSpacing, 0, 5);
+
+    currentStateConfig.roomWidth = std::clamp(currentStateConfig.roomWidth, 2, 100);
+    currentStateConfig.roomHeight = std::clamp(currentStateConfig.roomHeight, 2, 100);
+    currentStateConfig.roomMaxWidth = std::clamp(currentStateConfig.roomMaxWidth, currentStateConfig.roomWidth, 100);
+    currentStateConfig.roomMaxHeight = std::clamp(currentStateConfig.roomMaxHeight, currentStateConfig.roomHeight, 100);
+    ImGui::Text("Placed %d / %d rooms in %.2f ms", mazeComplexObject.getPlacedRooms(),
+        mazeComplexObject.getRequestedRooms(), mazeComplexObject.getRoomPlacementMs());
+    ImGui::InputScalar("Seed (0 = random)", ImGuiDataType_U32, &currentStateConfig.seed);
+
     ImGui::SeparatorText("Fun Settings");
     ImGui::DragFloat("Maze Angle", &currentStateConfig.angle, 2.0f, -180.0f, 180.0f);
     if (currentStateConfig.angle < -180.0f) currentStateConfig.angle = -180.0f;
     if (currentStateConfig.angle > 180.0f) currentStateConfig.angle = 180.0f;
 
+    ImGui::SeparatorText("Performance");
+    // Upload starts out picked for the backend. Compare the upload phase below between settings, a
+    // second streaming texture only pays off on drivers that stall uploading into a texture in use
+    ImGui::SliderInt("Streaming textures", &currentStateConfig.streamingTextures, 1, TextureRing::maxSlots);
+    static const char* uploadNames[] = {"SDL_UpdateTexture", "SDL_LockTexture"};
+    int uploadMethod = currentStateConfig.uploadMethod;
+    if (ImGui::Combo("Upload", &uploadMethod, uploadNames, IM_ARRAYSIZE(uploadNames))) {
+        currentStateConfig.uploadMethod = (UploadMethod) uploadMethod;
+    }
+    ImGui::Text("Raster: %s kernel, %d threads, %s", rasterKernelName(), mazeComplexObject.getRasterThreads(),
+        SDL_GetPixelFormatName(pixelFormatFor(pixelLayout)));
+    ImGui::Text("Wall quads: %d", mazeComplexObject.getWallQuads());
+    ImGui::Text("LOD: %s, pyramid %.1f MB", mazeComplexObject.getOverviewLevel() > 0 ? "overview" : "cells",
+        (double) mazeComplexObject.getLodBytes() / (1024.0 * 1024.0));
+    if (renderConfig.renderMode == RENDER_TILED) {
+        const TileCache& tiles = mazeComplexObject.getTileCache();
+        ImGui::Text("Tiles: %d cached, %.1f / %.0f MB, hit rate %.0f%%", tiles.getTileCount(),
+            (double) tiles.getBytes() / (1024.0 * 1024.0), (double) tiles.getBudget() / (1024.0 * 1024.0),
+            tiles.getHitRate() * 100.0);
+    }
+    // Idle textures wait for reuse, a count that keeps climbing means something isn't trimming the pool
+    ImGui::Text("Textures: %d, %d idle (%.1f MB)", texturePool.getTextureCount(), texturePool.getIdleCount(),
+        (double) texturePool.getBytes() / (1024.0 * 1024.0));
+    ImGui::Text("Frame %.2f ms, CPU %.0f%%, paced by %s", scheduler.getFrameMs(),
+        scheduler.getCpuUtilization() * 100.0, scheduler.isVsyncPacing() ? "vsync" : "sleep");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        ImGui::Text("%-8s %6.2f ms", FrameTimer::phaseName((FramePhase) phase), frameTimer.getMs((FramePhase) phase));
+    }
+
+    if (FrameCapture::isSupported()) {
+        ImGui::SeparatorText("Capture");
+        ImGui::BeginDisabled(capture.isActive());
+        static const char* captureNames[] = {"PNG sequence", "Raw RGBA"};
+        int format = captureSettings.format;
+        if (ImGui::Combo("Format", &format, captureNames, IM_ARRAYSIZE(captureNames))) {
+            captureSettings.format = (CaptureFormat) format;
+            if (captureSettings.format == CAPTURE_RAW && captureSettings.output == "frame.png") {
+                captureSettings.output = "-";
+            } else if (captureSettings.format == CAPTURE_PNG && captureSettings.output == "-") {
+                captureSettings.output = "frame.png";
+            }
+        }
+        ImGui::SliderInt("Every Nth frame", &captureSettings.every, 1, 60);
+        ImGui::SliderInt("Buffers", &captureSettings.bufferCount, 2, 64);
+        ImGui::SliderInt("Workers", &captureSettings.workerCount, 1, 8);
+        ImGui::EndDisabled();
+        ImGui::Text("Output: %s", captureSettings.output == "-" ? "stdout" : captureSettings.output.c_str());
+        if (ImGui::Button(capture.isActive() ? "Stop capture" : "Start capture")) {
+            if (capture.isActive()) {
+                capture.stop();
+            } else {
+                startCapture();
+            }
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("Records pixel mode with CPU walls");
+        ImGui::Text("Frames: %llu queued, %llu written, %llu dropped, %llu failed",
+            (unsigned long long) capture.getQueued(), (unsigned long long) capture.getWritten(),
+            (unsigned long long) capture.getDropped(), (unsigned long long) capture.getFailed());
+        if (capture.isActive()) {
+            ImGui::Text("Buffers in use: %d / %d", capture.getBuffersInUse(), capture.getBufferCount());
+        }
+    }
+
     if(ImGui::Button("Regenerate Maze")) {
-        uiParamsChanged = true;
+        pendingImpact = TOPOLOGY_CHANGE;
+    }
+
+    // Only escalate, several widgets can change in the same frame
+    ConfigImpact impact = currentStateConfig.classify(renderConfig);
+    if (impact != NO_CHANGE) {
+        renderConfig = currentStateConfig;
+        pendingImpact = std::max(pendingImpact, impact);
     }
     ImGui::End();
 }
 
 void Game::updateGame() {
-    while(!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16));
+    // Sleeps until the frame is due, or returns right away when vsync paces present
+    scheduler.waitForNextFrame();
 
-    float deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
+    float deltaTime = (float) scheduler.getFrameMs() / 1000.0f;
     if (deltaTime > 0.05f){
         deltaTime = 0.05f;
     }
+    app.deltaTime = deltaTime;
     bool windowPointer = true;
     mTicksCount = SDL_GetTicks();
+    frameTimer.begin(PHASE_UPDATE);
     ImGui_ImplSDLRenderer2_NewFrame();
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
 
     renderUI(&windowPointer);
 
-    if (uiParamsChanged) {
-        mazeComplexObject.configureRooms(uiNumRooms, uiRoomWidth, uiRoomHeight);
-        mazeComplexObject.resetMazeComplex();
-        mazeComplexObject.initMazeComplex();
-        uiParamsChanged = false;
+    // View changes (angle, pacing) are picked up by displayMazeComplex on its own
+    switch (pendingImpact) {
+        case TOPOLOGY_CHANGE: {
+            int gridWidth = mazeComplexObject.getGridWidth(), gridHeight = mazeComplexObject.getGridHeight();
+            mazeComplexObject.configureRooms(renderConfig.roomLayout());
+            mazeComplexObject.resetMazeComplex();
+            mazeComplexObject.initMazeComplex();
+            // Regenerating keeps the view, a different grid starts over at 1:1
+            if (gridWidth != mazeComplexObject.getGridWidth() || gridHeight != mazeComplexObject.getGridHeight()) {
+                camera.reset();
+            }
+            break;
+        }
+        case RASTER_CHANGE:
+            mazeComplexObject.updateRasterConfig();
+            clampCamera();
+            break;
+        default: ;
     }
+    pendingImpact = NO_CHANGE;
 
-    mazeComplexObject.updateMazeComplex(mTicksCount);
+    // Generation runs on fixed steps of simulated time, as many as are due this frame
+    Uint32 simulationTime;
+    while (scheduler.nextStep(simulationTime)) {
+        mazeComplexObject.updateMazeComplex(simulationTime);
+    }
+    frameTimer.end(PHASE_UPDATE);
 };
 
+/**
+ * @name isStaticFrame
+ * @brief A frame with no input for a few frames, no text field being edited, and a maze that would
+ * draw the same as last time (see MazeComplex::isFrameStatic). Generation steps and config changes
+ * show up as maze damage.
+ * @return bool
+ * @memberof Game
+ */
+bool Game::isStaticFrame(){
+    return activeFrames == 0 && !app.io->WantTextInput && mazeComplexObject.isFrameStatic(mTicksCount);
+}
+
 void Game::generateOutput(){
+    // Same picture as on screen already, skip raster and present and wait for events next frame
+    idle = isStaticFrame();
+    if (idle) {
+        ImGui::EndFrame();
+        return;
+    }
+    activeFrames = std::max(activeFrames - 1, 0);
+
+    frameTimer.begin(PHASE_PRESENT);
     ImGui::Render();
-    SDL_RenderSetScale(app.renderer, app.io->DisplayFramebufferScale.x, app.io->DisplayFramebufferScale.y);
+    // The maze draws in output pixels, unscaled. The ImGui backend applies DisplayFramebufferScale itself
+    // while the render scale is left at 1
+    SDL_RenderSetScale(app.renderer, 1.0f, 1.0f);
+    frameTimer.end(PHASE_PRESENT);
 
+    // Times its own raster and upload phases
     mazeComplexObject.displayMazeComplex(mTicksCount);
+    // A copy into the capture pool, the workers do the rest. Static frames aren't drawn or captured.
+    if (capture.isActive() && isCaptureSource()) {
+        capture.submit(mazeComplexObject.getFramebuffer().data(), app.screenWidth, app.screenHeight);
+    }
+
+    frameTimer.begin(PHASE_PRESENT);
     ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), app.renderer);
     SDL_RenderPresent(app.renderer);
+    frameTimer.end(PHASE_PRESENT);
+    frameTimer.endFrame();
 }
 
 void Game::shutdown(){
-    cleanup(app);
+    // Writes out the frames still queued
+    capture.stop();
+    // Textures have to go before the renderer does
+    texturePool.destroyAll();
+    if (app.renderer) {
+        cleanup(app);
+    }
 }
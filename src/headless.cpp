@@ -0,0 +1,162 @@
+#include <headless.hpp>
+#include <game.hpp>
+#include <utils.hpp>
+#include <cstdio>
+
+/**
+ * @name headlessUsage
+ * @brief Prints the headless command line options
+ */
+static void headlessUsage(){
+    printf("Usage: maze --headless [options]\n"
+           "  --size WxH      image size in pixels (1024x1024)\n"
+           "  --cell N        cell size in pixels (4)\n"
+           "  --grid WxH      maze size in cells, zoomed out to fit if bigger than the image (fits the image)\n"
+           "  --rooms N       number of rooms (0)\n"
+           "  --seed N        seed of the first maze, the next ones count up (random)\n"
+           "  --count N       number of mazes to render (1)\n"
+           "  --time MS       color wave time to color the mazes at (0)\n"
+           "  --bench N       re-rasterize N animated frames of the first maze and print the timings\n"
+           "  --out PATH      image to write, .png or .bmp; numbered when --count is above 1 (maze.png)\n"
+           "Writing no images: --out \"\"\n");
+}
+
+/**
+ * @name parseSize
+ * @brief Reads "WxH"
+ * @param text
+ * @param width, height - out
+ * @return bool - true if both are positive
+ */
+static bool parseSize(const char* text, int& width, int& height){
+    return sscanf(text, "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+}
+
+/**
+ * @name parseHeadlessArgs
+ * @brief Looks for --headless and reads the options after it
+ * @param argc, argv - command line
+ * @param options - out
+ * @param valid - out, false if an option was malformed (usage has been printed)
+ * @return bool - true if this is a headless run
+ */
+bool parseHeadlessArgs(int argc, char** argv, HeadlessOptions& options, bool& valid){
+    valid = true;
+    bool headless = false;
+    std::string bad;    // Only reported for headless runs, windowed runs may get arguments from the platform
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        const char* value = hasValue ? argv[i + 1] : "";
+        bool ok = true;
+        if (arg == "--headless") {
+            headless = true;
+            continue;
+        } else if (arg == "--size") {
+            ok = hasValue && parseSize(value, options.width, options.height);
+        } else if (arg == "--grid") {
+            ok = hasValue && parseSize(value, options.gridWidth, options.gridHeight);
+        } else if (arg == "--cell") {
+            ok = hasValue && sscanf(value, "%d", &options.cellSize) == 1 && options.cellSize > 0;
+        } else if (arg == "--rooms") {
+            ok = hasValue && sscanf(value, "%d", &options.rooms) == 1 && options.rooms >= 0;
+        } else if (arg == "--seed") {
+            ok = hasValue && sscanf(value, "%u", &options.seed) == 1;
+        } else if (arg == "--count") {
+            ok = hasValue && sscanf(value, "%d", &options.count) == 1 && options.count > 0;
+        } else if (arg == "--time") {
+            ok = hasValue && sscanf(value, "%u", &options.time) == 1;
+        } else if (arg == "--bench") {
+            ok = hasValue && sscanf(value, "%d", &options.benchFrames) == 1 && options.benchFrames >= 0;
+        } else if (arg == "--out") {
+            ok = hasValue;
+            options.output = value;
+        } else {
+            ok = false;
+            hasValue = false;
+        }
+        if (!ok && valid) {
+            bad = arg + (hasValue ? " " + std::string(value) : "");
+            valid = false;
+        }
+        i += hasValue ? 1 : 0;
+    }
+    if (headless && !valid) {
+        printf("Bad option %s\n", bad.c_str());
+        headlessUsage();
+    }
+    return headless;
+}
+
+/**
+ * @name runHeadless
+ * @brief Renders mazes without a window. Every maze is generated complete, rasterized once and saved.
+ * With --bench the first maze is then re-rasterized frame after frame with the color wave moving, which
+ * times the raster path (LUT, damage, CPU fill) with no upload or present in the way.
+ * @param options
+ * @return int - process exit code
+ */
+int runHeadless(const HeadlessOptions& options){
+    Application app{};
+    Game game(app);
+    MazeRenderConfig config{};
+    config.renderByFrame = false;
+    config.numRooms = options.rooms;
+    config.roomWidth = 5;
+    config.roomHeight = 5;
+    config.pixelSize = options.cellSize;
+    config.gridWidth = options.gridWidth;
+    config.gridHeight = options.gridHeight;
+    if (!game.initializeHeadless(options.width, options.height, config)) {
+        printf("Could not set up a %dx%d headless renderer\n", options.width, options.height);
+        return EXIT_FAILURE;
+    }
+
+    // Without --seed the first maze still gets a concrete one, so --bench can generate it again
+    unsigned int firstSeed = options.seed;
+    if (firstSeed == 0) {
+        firstSeed = 1 + (unsigned int) std::rand();
+        printf("Seed %u\n", firstSeed);
+    }
+    int failed = 0;
+    for (int i = 0; i < options.count; i++) {
+        game.renderConfig.seed = firstSeed + i;
+        Uint64 start = SDL_GetPerformanceCounter();
+        game.generateHeadless();
+        game.drawHeadless(options.time);
+        double ms = (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / (double) SDL_GetPerformanceFrequency();
+        if (options.output.empty()) {
+            printf("Maze %d generated and rasterized in %.2f ms\n", i + 1, ms);
+            continue;
+        }
+        std::string path = options.count > 1 ? numberedPath(options.output, i + 1, 4) : options.output;
+        bool saved = game.saveFrame(path);
+        failed += saved ? 0 : 1;
+        printf("%s %s (%.2f ms)\n", saved ? "Wrote" : "Failed", path.c_str(), ms);
+    }
+
+    if (options.benchFrames > 0) {
+        game.renderConfig.seed = firstSeed;
+        game.generateHeadless();
+        game.drawHeadless(options.time);
+        std::vector<double> frames(options.benchFrames);
+        Uint64 frequency = SDL_GetPerformanceFrequency();
+        for (int f = 0; f < options.benchFrames; f++) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            game.drawHeadless(options.time + (Uint32) (f + 1) * 16);
+            frames[f] = (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / (double) frequency;
+        }
+        std::vector<double> sorted = frames;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double ms : frames) {
+            total += ms;
+        }
+        printf("Raster %d frames at %dx%d: mean %.3f ms, median %.3f ms, p95 %.3f ms, max %.3f ms\n",
+            options.benchFrames, options.width, options.height, total / options.benchFrames,
+            sorted[sorted.size() / 2], sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)],
+            sorted.back());
+    }
+    game.shutdown();
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -44,7 +44,7 @@ bool initSDL(Application &app, const std::string& title){
         app.window = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
                         (int) (SCREEN_WIDTH * main_scale), 
                         (int) (SCREEN_HEIGHT * main_scale), 
-                        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+                        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
         if (app.window == nullptr){
             throw_sdl_error("Create window failed %s");
             success = false;
@@ -67,6 +67,7 @@ bool initSDL(Application &app, const std::string& title){
                 ImGui_ImplSDL2_InitForSDLRenderer(app.window, app.renderer);
                 ImGui_ImplSDLRenderer2_Init(app.renderer);
                 SDL_SetRenderDrawColor(app.renderer, 0x00, 0x00, 0x00, 255);
+                updateOutputSize(app);
                 int imgFlags = IMG_INIT_PNG | IMG_INIT_JPG;
                 if (!(IMG_Init(imgFlags) & imgFlags)){
                     printf("SDL_image could not initialize, Error: %s", SDL_GetError());
@@ -81,6 +82,28 @@ bool initSDL(Application &app, const std::string& title){
     return success;
 }
 
+/**
+ * @name updateOutputSize
+ * @brief Reads the size the renderer actually draws at. On HiDPI displays that's more pixels than the
+ * window has logical units, and the maze is rasterized at this size so nothing gets resampled.
+ * pixelScale converts window coordinates (mouse events) to it.
+ * @param app - Application struct reference
+ * @return bool - true if the output size changed
+ */
+bool updateOutputSize(Application &app){
+    int outputWidth = app.screenWidth, outputHeight = app.screenHeight;
+    int windowWidth = 0, windowHeight = 0;
+    SDL_GetRendererOutputSize(app.renderer, &outputWidth, &outputHeight);
+    SDL_GetWindowSize(app.window, &windowWidth, &windowHeight);
+    app.pixelScale = windowWidth > 0 ? (float) outputWidth / (float) windowWidth : 1.0f;
+    if (outputWidth == app.screenWidth && outputHeight == app.screenHeight) {
+        return false;
+    }
+    app.screenWidth = outputWidth;
+    app.screenHeight = outputHeight;
+    return true;
+}
+
 /**
  * Cleanup environment and app struct reference.
  * Cleanup ImGui, SDL renderer, and SDL window.
@@ -0,0 +1,128 @@
+#include <lod_pyramid.hpp>
+
+// Standing walls per 4 bit wall mask
+static constexpr Uint8 wallCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/**
+ * @name build
+ * @brief Sums the cells into level 1, then each level into the next from its 2x2 children.
+ * Level storage is reused when the next maze has the same size.
+ * @param cellsX, cellsY - grid size
+ * @param maze - cells, for the visited flag
+ * @param distance - path distance per cell
+ * @param walls - wall mask per cell (see directionBit)
+ * @memberof LodPyramid
+ */
+void LodPyramid::build(int cellsX, int cellsY, const MazeElement* maze, const Uint32* distance, const Uint8* walls){
+    this->cellsX = cellsX;
+    this->cellsY = cellsY;
+    int levelCount = 1;
+    while ((1 << levelCount) < std::max(cellsX, cellsY)) {
+        levelCount++;
+    }
+    levels.resize(levelCount);
+    widths.resize(levelCount);
+    heights.resize(levelCount);
+    for (int level = 1; level <= levelCount; level++) {
+        widths[level - 1] = (cellsX + (1 << level) - 1) >> level;
+        heights[level - 1] = (cellsY + (1 << level) - 1) >> level;
+        levels[level - 1].assign((size_t) widths[level - 1] * heights[level - 1], LodBlock{0, 0, 0});
+    }
+
+    std::vector<LodBlock>& first = levels[0];
+    for (int y = 0; y < cellsY; y++) {
+        LodBlock* row = &first[(size_t) (y >> 1) * widths[0]];
+        for (int x = 0; x < cellsX; x++) {
+            int cell = y * cellsX + x;
+            LodBlock& target = row[x >> 1];
+            target.walls += wallCount[walls[cell] & ALL_DIRECTIONS];
+            if (maze[cell].visited) {
+                target.visited++;
+                target.distanceSum += distance[cell];
+            }
+        }
+    }
+    for (int level = 2; level <= levelCount; level++) {
+        const std::vector<LodBlock>& below = levels[level - 2];
+        int belowWidth = widths[level - 2], belowHeight = heights[level - 2];
+        std::vector<LodBlock>& current = levels[level - 1];
+        for (int y = 0; y < belowHeight; y++) {
+            for (int x = 0; x < belowWidth; x++) {
+                const LodBlock& child = below[(size_t) y * belowWidth + x];
+                LodBlock& parent = current[(size_t) (y >> 1) * widths[level - 1] + (x >> 1)];
+                parent.visited += child.visited;
+                parent.walls += child.walls;
+                parent.distanceSum += child.distanceSum;
+            }
+        }
+    }
+}
+
+/**
+ * @name addVisited
+ * @brief A cell was visited, add it to every block above it
+ * @param x, y - cell position
+ * @param distance - its path distance
+ * @memberof LodPyramid
+ */
+void LodPyramid::addVisited(int x, int y, Uint32 distance){
+    for (int level = 1; level <= (int) levels.size(); level++) {
+        LodBlock& target = levels[level - 1][(size_t) (y >> level) * widths[level - 1] + (x >> level)];
+        target.visited++;
+        target.distanceSum += distance;
+    }
+}
+
+/**
+ * @name removeWall
+ * @brief One wall of a cell came down
+ * @param x, y - cell position
+ * @memberof LodPyramid
+ */
+void LodPyramid::removeWall(int x, int y){
+    for (int level = 1; level <= (int) levels.size(); level++) {
+        levels[level - 1][(size_t) (y >> level) * widths[level - 1] + (x >> level)].walls--;
+    }
+}
+
+/**
+ * @name levelFor
+ * @brief The finest level whose blocks are at least a pixel wide, so every cell is counted by some
+ * pixel and nothing is skipped. 0 means cells are big enough to draw one by one.
+ * @param cellsPerPixel - how many cells fit across one screen pixel
+ * @return int - level, 0 to getLevelCount()
+ * @memberof LodPyramid
+ */
+int LodPyramid::levelFor(double cellsPerPixel) const{
+    if (cellsPerPixel <= 1.0) {
+        return 0;
+    }
+    return std::clamp((int) std::ceil(std::log2(cellsPerPixel)), 1, (int) levels.size());
+}
+
+/**
+ * @name blockCells
+ * @brief How many cells a block covers, fewer than 4^level along the right and bottom edges of the grid
+ * @param level
+ * @param x, y - block position in the level
+ * @return int
+ * @memberof LodPyramid
+ */
+int LodPyramid::blockCells(int level, int x, int y) const{
+    int size = 1 << level;
+    return std::min(size, cellsX - x * size) * std::min(size, cellsY - y * size);
+}
+
+/**
+ * @name getBytes
+ * @brief Memory held by the pyramid
+ * @return size_t
+ * @memberof LodPyramid
+ */
+size_t LodPyramid::getBytes() const{
+    size_t bytes = 0;
+    for (const std::vector<LodBlock>& level : levels) {
+        bytes += level.capacity() * sizeof(LodBlock);
+    }
+    return bytes;
+}
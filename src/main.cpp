@@ -1,6 +1,7 @@
 #include <common.hpp>
 #include <cmath>
 #include <game.hpp>
+#include <headless.hpp>
 
 /**
  * @brief Initialize Game and run main loop
@@ -22,8 +23,17 @@ void main_loop() {
 }
 
 int main(int argc, char** argv){
+#ifndef __EMSCRIPTEN__
+    // Batch images and benchmarks, no window or renderer
+    HeadlessOptions headless;
+    bool valid;
+    if (parseHeadlessArgs(argc, argv, headless, valid)) {
+        return valid ? runHeadless(headless) : 2;
+    }
+#endif
     g_app = new Application();
     g_game = new Game(*g_app);
+    parseCaptureArgs(argc, argv, g_game->captureSettings);
     if (g_game->initialize("Maze - Prims Algorithm - Simulation")) {
 #ifdef __EMSCRIPTEN__
         emscripten_set_main_loop(main_loop, 0, 1);
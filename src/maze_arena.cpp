@@ -0,0 +1,149 @@
+#include <maze_arena.hpp>
+
+/**
+ * MazeArena Constructor
+ * @brief Creates an empty arena, no memory is requested until the first allocation
+ * @param upstream - memory_resource blocks are requested from
+ * @memberof MazeArena
+ */
+MazeArena::MazeArena(std::pmr::memory_resource* upstream)
+: upstream(upstream) {
+}
+
+MazeArena::~MazeArena(){
+    releaseAll();
+}
+
+MazeArena::MazeArena(MazeArena&& other) noexcept
+: upstream(other.upstream), block(other.block), capacity(other.capacity), offset(other.offset),
+  overflow(other.overflow), overflowBytes(other.overflowBytes) {
+    other.block = nullptr;
+    other.capacity = 0;
+    other.offset = 0;
+    other.overflow = nullptr;
+    other.overflowBytes = 0;
+}
+
+MazeArena& MazeArena::operator=(MazeArena&& other) noexcept {
+    if (this != &other) {
+        releaseAll();
+        upstream = other.upstream;
+        block = other.block;
+        capacity = other.capacity;
+        offset = other.offset;
+        overflow = other.overflow;
+        overflowBytes = other.overflowBytes;
+        other.block = nullptr;
+        other.capacity = 0;
+        other.offset = 0;
+        other.overflow = nullptr;
+        other.overflowBytes = 0;
+    }
+    return *this;
+}
+
+/**
+ * @name allocateBytes
+ * @brief Bumps the offset in the main block. When the block is full the request is served from its own
+ * overflow chunk, remembered so reset() can size the next block to fit the whole maze.
+ * @param bytes - size of the request
+ * @param alignment - required alignment, at most alignof(std::max_align_t)
+ * @return void* - uninitialized storage
+ * @memberof MazeArena
+ */
+void* MazeArena::allocateBytes(size_t bytes, size_t alignment){
+    size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+    if (block != nullptr && aligned + bytes <= capacity) {
+        offset = aligned + bytes;
+        return block + aligned;
+    }
+    size_t header = (sizeof(OverflowChunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    size_t chunkSize = header + bytes;
+    auto* chunk = static_cast<OverflowChunk*>(upstream->allocate(chunkSize, alignof(std::max_align_t)));
+    chunk->next = overflow;
+    chunk->size = chunkSize;
+    overflow = chunk;
+    overflowBytes += bytes + alignment;
+    return reinterpret_cast<std::byte*>(chunk) + header;
+}
+
+/**
+ * @name reset
+ * @brief Drops everything allocated since the last reset. O(1) in the steady state, just rewinds
+ * the offset. If the last maze spilled into overflow chunks, they and the main block are replaced by
+ * one block big enough for all of it.
+ * @memberof MazeArena
+ */
+void MazeArena::reset(){
+    if (overflow != nullptr) {
+        size_t needed = offset + overflowBytes;
+        releaseAll();
+        capacity = needed + needed / 4;
+        block = static_cast<std::byte*>(upstream->allocate(capacity, alignof(std::max_align_t)));
+    }
+    offset = 0;
+}
+
+/**
+ * @name releaseAll
+ * @brief Hands the main block and every overflow chunk back upstream
+ * @memberof MazeArena
+ */
+void MazeArena::releaseAll(){
+    while (overflow != nullptr) {
+        OverflowChunk* next = overflow->next;
+        upstream->deallocate(overflow, overflow->size, alignof(std::max_align_t));
+        overflow = next;
+    }
+    overflowBytes = 0;
+    if (block != nullptr) {
+        upstream->deallocate(block, capacity, alignof(std::max_align_t));
+        block = nullptr;
+    }
+    capacity = 0;
+    offset = 0;
+}
+
+/**
+ * @name attach
+ * @brief Allocates the frontier's storage for a grid of numCells cells and empties it
+ * @param arena - arena owning the current maze
+ * @param numCells - number of cells in the grid
+ * @memberof Frontier
+ */
+void Frontier::attach(MazeArena& arena, int numCells){
+    cells = arena.allocate<int>(numCells);
+    slot = arena.allocate<int>(numCells);
+    std::fill(slot.begin(), slot.end(), -1);
+    count = 0;
+}
+
+/**
+ * @name insert
+ * @brief Adds a cell unless it's already in the frontier
+ * @param cell - cell index
+ * @memberof Frontier
+ */
+void Frontier::insert(int cell){
+    if (slot[cell] >= 0) {
+        return;
+    }
+    slot[cell] = count;
+    cells[count++] = cell;
+}
+
+/**
+ * @name takeAt
+ * @brief Removes and returns the cell at a position in the dense list. The last cell moves into the gap.
+ * @param index - position in [0, size())
+ * @return int - cell index that was removed
+ * @memberof Frontier
+ */
+int Frontier::takeAt(int index){
+    int cell = cells[index];
+    int last = cells[--count];
+    cells[index] = last;
+    slot[last] = index;
+    slot[cell] = -1;
+    return cell;
+}
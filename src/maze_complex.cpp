@@ -21,12 +21,14 @@ MazeComplex::MazeComplex(){
  * @brief Constructor, used in @game.cpp
  * @param game - Game Object, Dependency injection 
  * @param config - ColorConfig object, configures maze color options
+ * @param upstream - memory_resource the maze arena draws its blocks from
  * @memberof MazeComplex
  */
 MazeComplex::MazeComplex(
     Game* game,
-    ColorConfig* config
-){
+    ColorConfig* config,
+    std::pmr::memory_resource* upstream
+): arena(upstream), rasterPool(std::make_unique<ThreadPool>()) {
     this->mazeComplete = false;
     this->background = {0x10, 0x10, 0x10, 255};
     this->wallColor = {255, 255, 255, 255};
@@ -39,80 +41,166 @@ MazeComplex::MazeComplex(
 /**
  * @name initMazeComplex
  * @brief Initializes the mazeComplex object. This consists of:
- * 1. Set up maze grid, dividing screen by pixel size to get number of cells in x and y directions
- * 2. Create structures that hold CELL structure types for each cell
- * 3. Determine if rooms have been added via configuration, if so, call addRoom
+ * 1. Set up maze grid, the configured grid size or, when that's 0, the screen divided by pixel size.
+ *    The grid isn't tied to the window, the camera decides which part of it is on screen
+ * 2. Allocate the per-cell arrays from the arena. Plain cells need no structure, every side is a boundary with a wall
+ * 3. Lay out the configured rooms with RoomLayout and create a structure for each, then build the
+ *    LOD pyramid over the fresh grid
  * 4. Create starting cell, set startX and startY
- * 5. Calculate maxDistance as manhatten distance from start to a corner
+ * 5. Reset the path distance field, the start is depth 0 and maxDistance grows as cells are carved
  * 6. Initialize frontier with neighbors of starting cell
+ * 7. Clear the damage tracking, the new texture needs one full redraw
  * @memberof MazeComplex
  */
 void MazeComplex::initMazeComplex(){
     this->pixelSize = game->renderConfig.pixelSize;
     this->mazeComplete = false;
-    this->numCellX = game->app.screenWidth / pixelSize;
-    this->numCellY = game->app.screenHeight / pixelSize;
-    mazeTexture = SDL_CreateTexture(
-        game->app.renderer,
-        SDL_PIXELFORMAT_ARGB8888,
-        SDL_TEXTUREACCESS_STREAMING,
-        game->app.screenWidth,
-        game->app.screenHeight
-    );
-    for(int i =0; i < numCellX * numCellY; i++){
+    const MazeRenderConfig& config = game->renderConfig;
+    this->numCellX = std::max(1, config.gridWidth > 0 ? config.gridWidth : game->app.screenWidth / pixelSize);
+    this->numCellY = std::max(1, config.gridHeight > 0 ? config.gridHeight : game->app.screenHeight / pixelSize);
+    this->numCellY = std::min(numCellY, MazeRenderConfig::maxGridCells / numCellX);
+    framebuffer.resize((size_t) game->app.screenWidth * game->app.screenHeight);
+    // Packed straight in the renderer's texture format, so uploads need no conversion
+    backgroundValue = packColor(game->pixelLayout, background);
+    wallColorValue = packColor(game->pixelLayout, wallColor);
+    int numCells = numCellX * numCellY;
+    maze = arena.allocate<MazeElement>(numCells);
+    for(int i =0; i < numCells; i++){
         int gridX = i % numCellX;
         int gridY = i / numCellX;
-        auto cell = std::make_shared<MazeStructure>(1, 1, gridX, gridY, numCellX);
-        maze.emplace_back(gridX, gridY, i, cell);
+        new (&maze[i]) MazeElement(gridX, gridY, i, NO_STRUCTURE);
     }
 
-    int start = std::rand() % (numCellX * numCellY);
-
-    for(int i = 0; i <configNumRooms; i++){
+    if (game->renderConfig.seed != 0) {
+        std::srand(game->renderConfig.seed);
+    }
+    pathDistance = arena.allocate<Uint32>(numCells);
+    std::fill(pathDistance.begin(), pathDistance.end(), 0);
+    maxDistance = 0;
+    cellBoundary = arena.allocate<Uint8>(numCells);
+    std::fill(cellBoundary.begin(), cellBoundary.end(), ALL_DIRECTIONS);
+    cellWalls = arena.allocate<Uint8>(numCells);
+    std::fill(cellWalls.begin(), cellWalls.end(), ALL_DIRECTIONS);
+    cellDirty = arena.allocate<Uint8>(numCells);
+    std::fill(cellDirty.begin(), cellDirty.end(), 0);
+    dirtyCells = arena.allocate<int>(numCells);
+    dirtyCount = 0;
+    nextAtDistance = arena.allocate<int>(numCells);
+    distanceHead.clear();
+    distanceCount.clear();
+    // Prim's mazes have short paths, the longest measured about the grid's width plus height. Reserving
+    // twice that keeps these from growing mid generation, a longer path still grows them geometrically
+    size_t distances = std::min<size_t>(numCells, (size_t) 4 * std::max(numCellX, numCellY));
+    distanceHead.reserve(distances);
+    distanceCount.reserve(distances);
+    colorLut.reserve(distances);
+    previousLut.reserve(distances);
+    lutWave.reserve(distances);
+    applyRenderMode();
+    frontier.attach(arena, numCells);
+    occupancy.reset(numCellX, numCellY);
 
-        addRoom(configRoomWidth, configRoomHeight);
+    roomLayout.generate(roomConfig, occupancy, placedRooms);
+    structures = arena.allocate<MazeStructure>((int) placedRooms.size());
+    structureCount = 0;
+    for (const RoomRect& room : placedRooms){
+        placeRoom(room.x, room.y, room.width, room.height);
+    }
+    lod.build(numCellX, numCellY, maze.begin(), pathDistance.begin(), cellWalls.begin());
+    // Room interiors can't connect to anything, so the start has to be on a boundary
+    int start = std::rand() % numCells;
+    while (cellBoundary[start] == 0) {
+        start = std::rand() % numCells;
     }
     maze[start].visited = true;
     maze[start].generationTime = 0;
+    addToDistanceBucket(start);
+    lod.addVisited(maze[start].gridX, maze[start].gridY, 0);
+    trackRoomReveal(start, 0);
     startX = maze[start].gridX;
     startY = maze[start].gridY;
 
-    int maxX = std::max(startX, numCellX - startX);
-    int maxY = std::max(startY, numCellY - startY);
-    maxDistance = maxX + maxY;
-    std::vector<int> neighbors = getNeighbors(maze[start], false);
-    frontier.insert(neighbors.begin(), neighbors.end());
-    //frontier.insert(frontier.end(), neighbors.begin(), neighbors.end());
+    int neighbors[4];
+    int count = getNeighbors(maze[start], false, neighbors);
+    for (int i = 0; i < count; i++) {
+        frontier.insert(neighbors[i]);
+    }
+}
+
+/**
+ * @name updateRasterConfig
+ * @brief Applies raster-only config changes (cell size) without touching the generated maze.
+ * The grid keeps its dimensions, so a bigger cell size crops the maze at the window edge
+ * and a smaller one leaves background around it. Regenerate to refit the grid to the window.
+ * Every cell moves, so the next frame is a full redraw. Also switches between pixel and cell rendering.
+ * @memberof MazeComplex
+ */
+void MazeComplex::updateRasterConfig(){
+    this->pixelSize = game->renderConfig.pixelSize;
+    applyRenderMode();
+}
 
+/**
+ * @name applyRenderMode
+ * @brief Picks up the configured render mode, wall drawing and texture ring size. In cell mode the screen
+ * textures only carry the CPU walls over a transparent background, so they're blended, and the cell
+ * textures have to exist. Either way the next frame is a full redraw, which also rebuilds the wall
+ * geometry and uploads every texture in the rings.
+ * Textures that are no longer needed (old sizes, the cell texture outside cell mode, the tiles outside
+ * tiled mode) are destroyed here.
+ * @memberof MazeComplex
+ */
+void MazeComplex::applyRenderMode(){
+    renderMode = game->renderConfig.renderMode;
+    gpuWalls = game->renderConfig.gpuWalls;
+    presentCurrent = false;
+    // Same size as last time (regenerating, render by frame) gets the same textures back. Headless there
+    // is nothing to upload to, the framebuffer is the result
+    if (game->app.renderer) {
+        screenRing.acquire(game->texturePool, game->app.renderer, pixelFormatFor(game->pixelLayout),
+            game->app.screenWidth, game->app.screenHeight, game->renderConfig.streamingTextures);
+    }
+    screenRing.setBlendMode(renderMode == RENDER_CELL ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    cellRing.release(game->texturePool);
+    ensureCellTexture();
+    if (renderMode != RENDER_TILED) {
+        tileCache.releaseAll(game->texturePool);
+    }
+    game->texturePool.trim();
+    fullRedraw = true;
 }
 
 /**
  * @name configureRooms
- * @brief Configures the number of rooms, width, and height
- * @param numRooms - Integer, number of rooms
- * @param width - Integer, width of each room
- * @param height - Integer, height of each room
+ * @brief Configures the room layout used by the next initMazeComplex
+ * @param layout - RoomLayoutConfig, number of rooms, size range, spacing and packing strategy
  * @memberof MazeComplex
  */
-void MazeComplex::configureRooms(int numRooms, int width, int height){
-    configNumRooms = numRooms;
-    configRoomWidth = width;
-    configRoomHeight = height;
+void MazeComplex::configureRooms(const RoomLayoutConfig& layout){
+    roomConfig = layout;
 }
 
 
 /**
  * @name resetMazeComplex
- * @brief Resets the mazeComplex object. This consists of:
- * 1. Clearing the maze and frontier vectors
- * 2. Normally we'd have to worry abou all the MazeStructure objects, but we use shared_ptrs
- * so they'll be cleaned up when the maze is cleared. (MazeElement with pointers to MazeStructure)
+ * @brief Resets the mazeComplex object. Every per-maze array (cells, structures, distances, masks,
+ * frontier) lives in the arena, so this is a single O(1) arena reset. The capacity is kept for the
+ * next initMazeComplex, which means cycling mazes doesn't allocate.
  * @memberof MazeComplex
  */
 void MazeComplex::resetMazeComplex(){
-    // Use a set to track unique pointers to avoid double deletion
-    maze.clear();
-    frontier.clear();
+    arena.reset();
+    maze = {};
+    structures = {};
+    structureCount = 0;
+    pathDistance = {};
+    cellBoundary = {};
+    cellWalls = {};
+    cellDirty = {};
+    dirtyCells = {};
+    nextAtDistance = {};
+    dirtyCount = 0;
+    frontier = {};
 }
 
 /**
@@ -133,30 +221,8 @@ void MazeComplex::resetMazeComplex(){
 void MazeComplex::generateCompleteMaze(){
 
     while(!frontier.empty()){
-        int randomIndex = std::rand() % frontier.size();
-        auto it = frontier.begin();
-        std::advance(it, randomIndex);
-        int cell = *it;
-        frontier.erase(it);
-        
-        
-        maze[cell].visited = true;
-        maze[cell].generationTime = 0;  // Set to 0 for instant generation
-        
-        int gridX = maze[cell].gridX;
-        int gridY = maze[cell].gridY;
-        int distance = calculateDistance(startX, startY, gridX, gridY);
-        maze[cell].distance = distance;
-        
-        chooseWallCandidate(cell);
-        
-        std::vector<int> unVisited = getNeighbors(maze[cell], false);
-        for(int neighbor : unVisited) {
-            frontier.insert(neighbor);
-            // if(std::find(frontier.begin(), frontier.end(), neighbor) == frontier.end()) {
-            //     frontier.push_back(neighbor);
-            // }
-        }
+        // Generation time 0 for instant generation
+        visitFrontierCell(std::rand() % frontier.size(), 0);
     }
     mazeComplete = true;
 }
@@ -202,78 +268,78 @@ void MazeComplex::updateMazeComplex(Uint32 currentTime){
 }
 
 /**
- * @name generateColor
- * @brief Generates a color based on the distance and time. 
- * Note, some params here are outdated, like mazeElemTime. 
- * We apply a sine function based on distance and time. If distance is un-normalized, it creates a color wave. 
- * Why? The distance is how far our cell is from the center. The sine curve will alternate through the colors
- * as the distance increases. If the distance is significant, then the time it will take to travel from center to edge has an effect. 
- * If we use unnormalize distance, we bind our distance between 0 and 1. So its effect becomes negligible, and 
- * every cell has about the same color. 
- * @param distance - Integer, distance from center
+ * @name buildColorLut
+ * @brief Builds the packed color of every path distance for this frame, in the renderer's PixelLayout, so
+ * coloring a cell is a single indexed load instead of a sine, three color conversions and a repack.
+ * We apply a sine function based on distance and time. If distance is un-normalized, it creates a color wave.
+ * Why? The distance is how far our cell is from the start, walking the maze's corridors. The sine curve will alternate through the colors
+ * as the distance increases. If the distance is significant, then the time it will take to travel from center to edge has an effect.
+ * If we use unnormalize distance, we bind our distance between 0 and 1. So its effect becomes negligible, and
+ * every cell has about the same color.
+ * Consecutive distances are a fixed angle apart, so the sine is stepped with a rotation and re-anchored with
+ * a real sin/cos every lutBlock entries to keep rounding from drifting. The band pick is branch free so the
+ * compiler can vectorize it.
  * @param time - Unsigned integer, current time in milliseconds
  * @memberof MazeComplex
  */
-SDL_Color MazeComplex::generateColor(int distance, Uint32 time){
-    SDL_Color color;
-    if(!mazeColorConfig->colorWave){
-        float normal_distance = (float) distance / (float) maxDistance;
-        // Clamp to prevent values > 1.0 that cause color inversion
-        distance = (int) normal_distance;
-        //distance = std::min(normal_distance, 1.0f);
-    }
-    SDL_Color first_color = ImVec4ToSDLColor(mazeColorConfig->color1);
-    SDL_Color second_color = ImVec4ToSDLColor(mazeColorConfig->color2);
-    SDL_Color third_color = ImVec4ToSDLColor(mazeColorConfig->color3);
-    float wave = sin((distance * mazeColorConfig->distanceCoef) -((float) time * mazeColorConfig->timeCoef)) * 0.5f + 0.5f;
-    float pulse = 1.0;
-
-    float intensity =  wave * pulse;
-    if (intensity < .33) {
-        color = first_color;
-    } else if(intensity < .66){
-        color = second_color;   
+void MazeComplex::buildColorLut(Uint32 time){
+    const ImVec4* configured[3] = {&mazeColorConfig->color1, &mazeColorConfig->color2, &mazeColorConfig->color3};
+    Uint32 palette[3];
+    for (int i = 0; i < 3; i++) {
+        palette[i] = packColor(game->pixelLayout, ImVec4ToSDLColor(*configured[i]));
+    }
+
+    int count = maxDistance + 1;
+    colorLut.resize(count);
+    lutWave.resize(count);
+    double step = mazeColorConfig->distanceCoef;
+    double phase = -((double) time * mazeColorConfig->timeCoef);
+    if (!mazeColorConfig->colorWave) {
+        // Normalized distance truncates to 0 for everything short of maxDistance, which gets 1
+        float first = (float) std::sin(phase) * 0.5f + 0.5f;
+        std::fill(lutWave.begin(), lutWave.end(), first);
+        if (maxDistance > 0) {
+            lutWave[maxDistance] = (float) std::sin(step + phase) * 0.5f + 0.5f;
+        }
     } else {
-        color = third_color;
+        double stepSin = std::sin(step), stepCos = std::cos(step);
+        for (int base = 0; base < count; base += lutBlock) {
+            double s = std::sin(base * step + phase), c = std::cos(base * step + phase);
+            int end = std::min(count, base + lutBlock);
+            for (int d = base; d < end; d++) {
+                lutWave[d] = (float) s * 0.5f + 0.5f;
+                double next = s * stepCos + c * stepSin;
+                c = c * stepCos - s * stepSin;
+                s = next;
+            }
+        }
+    }
+    const float* wave = lutWave.data();
+    Uint32* lut = colorLut.data();
+    for (int d = 0; d < count; d++) {
+        Uint32 low = wave[d] < .33f ? palette[0] : palette[1];
+        lut[d] = wave[d] < .66f ? low : palette[2];
     }
-    return color;
 }
 
 /**
  * @name mazeStructureNeighbors
- * @brief Helper function that iterates through a candidate cell. If its not a CELL type, then we have to 
- * check the structure's perimeter cells to find out if we can connect. A structure will have more than one
- * perimeter wall we need to check.
+ * @brief Helper function that iterates through a candidate cell. Only cells on a structure's boundary can
+ * connect, which is a single lookup in the boundary mask (plain CELLs are boundary on every side,
+ * room interiors on none).
  * If we can, its added as a neighbor candidate and processed.
- * @param nx - vector of integers, holds neighbor candidates
+ * @param nx - array of up to 4 integers, holds neighbor candidates
+ * @param count - number of entries used in nx, incremented when the neighbor qualifies
  * @param neighbor - MazeElement, the candidate neighbor cell
  * @param visited - Boolean, indicates if we're looking for visited or unvisited neighbors. This helps us find
  * unvisited or visited areas of the grid.
  * @memberof MazeComplex
  */
-void MazeComplex::mazeStructureNeighbors(std::vector<int> &nx, MazeElement& neighbor, bool visited){
+void MazeComplex::mazeStructureNeighbors(int (&nx)[4], int &count, const MazeElement& neighbor, bool visited){
 
-    auto neighborStruct = neighbor.parentStructure;
-    bool canConnect = true;
-    if(neighborStruct->structure != CELL){
-        canConnect = false;
-        for (const auto& perimCell : neighborStruct->perimeterCells) {
-            if (perimCell.cell == neighbor.place) {
-                canConnect = true;
-                break;
-            }
-        }
-    }
-    if(canConnect){
-        if (visited) {
-            if (neighbor.visited) {
-                nx.push_back(neighbor.place);
-            }
-        } else {
-            if (!neighbor.visited) {
-                nx.push_back(neighbor.place);
-            }
-        }
+    bool canConnect = cellBoundary[neighbor.place] != 0;
+    if(canConnect && neighbor.visited == visited){
+        nx[count++] = neighbor.place;
     }
 
 }
@@ -285,88 +351,59 @@ void MazeComplex::mazeStructureNeighbors(std::vector<int> &nx, MazeElement& neig
  * We loop through the directions, and use the helper function to calculate the positions.
  * @param current_element - MazeElement, current cell we're going to check neighbors
  * @param visited
- * @return std::vector<int> - vector of integers, holds neighbor candidates
+ * @param nx - filled with up to 4 neighbor candidates, a fixed array so the hot path never allocates
+ * @return int - number of neighbor candidates written to nx
  * @memberof MazeComplex
  */
-std::vector<int> MazeComplex::getNeighbors(const MazeElement& current_element, bool visited){
-    std::vector<int> nx;
+int MazeComplex::getNeighbors(const MazeElement& current_element, bool visited, int (&nx)[4]){
+    int count = 0;
     int place = current_element.place;
     int gridX = current_element.gridX;
     int gridY = current_element.gridY;
-    auto currentStruct = current_element.parentStructure;
 
     // Check all 4 directions for neighbors
-    std::unordered_map<int, bool> conditions = {
-        {place - 1, gridX > 0},
-        {place + 1, gridX < numCellX - 1},
-        {place - numCellX, gridY > 0},
-        {place + numCellX, gridY < numCellY - 1}
-    };
-    for( auto mapElem: conditions){
-        if (mapElem.second){
-            int neighborPlace = mapElem.first;
-            MazeElement& neighbor = maze[neighborPlace];
-            mazeStructureNeighbors(nx, neighbor, visited);
-        }
-    }
-    
-    return nx;
-}
-
-/**
- * @name addRoom
- * @brief Adds a room structure to the maze based on width and height. Do an exhaustive search to
- * find a valid position for the room.
- * @param width int - Room width
- * @param height int - Room height
- */
-void MazeComplex::addRoom(int width, int height){
-    int attempts = 20;
-    for (int i = 0; i < attempts; i++){
-        // Pick a random starting position
-        int randomIndex = std::rand() % maze.size();
-        MazeElement elem = maze[randomIndex];
-        int sX = elem.gridX;
-        int sY = elem.gridY;
-        
-        // Check if room fits within maze boundaries
-        if (sX + width > numCellX || sY + height > numCellY) {
-            continue;
-        }
-        
-        // Check if all cells in the room area are available (type CELL)
-        bool canPlaceRoom = true;
-        std::vector<int> roomCells;
-        
-        for (int y = sY; y < sY + height; y++){
-            for (int x = sX; x < sX + width; x++){
-                int cellIndex = y * numCellX + x;
-                MazeElement& cellElem = maze[cellIndex];
-                auto candidateStruct = cellElem.parentStructure;
-                
-                if (candidateStruct->structure != CELL) {
-                    canPlaceRoom = false;
-                    break;
-                }
-                roomCells.push_back(cellIndex);
-            }
-            if (!canPlaceRoom) break;
-        }
-        
-        // If we can place the room, create the room structure and update cells
-        if (canPlaceRoom) {
-            // Create new room structure
-            auto roomStruct = std::make_shared<MazeStructure>(width, height, sX, sY, numCellX);
-            roomStruct->structure = ROOM;
-            roomStruct->height = height;
-            roomStruct->width = width;
-            
-            // Update all cells in the room to point to the new room structure
-            for (int cellIndex : roomCells) {
-                maze[cellIndex].parentStructure = roomStruct;
-            }
-            
-            break;
+    if (gridX > 0) {
+        mazeStructureNeighbors(nx, count, maze[place - 1], visited);
+    }
+    if (gridX < numCellX - 1) {
+        mazeStructureNeighbors(nx, count, maze[place + 1], visited);
+    }
+    if (gridY > 0) {
+        mazeStructureNeighbors(nx, count, maze[place - numCellX], visited);
+    }
+    if (gridY < numCellY - 1) {
+        mazeStructureNeighbors(nx, count, maze[place + numCellX], visited);
+    }
+    return count;
+}
+
+/**
+ * @name placeRoom
+ * @brief Creates the room structure at a position already claimed in the occupancy grid and
+ * points every covered cell at it. The per-cell boundary masks are built here, once: a cell gets a
+ * bit for each room edge it sits on, interior cells get none so they can never connect to the maze.
+ * The caller guarantees a free slot in structures.
+ * @param sX, sY - top left cell of the room
+ * @param width, height - room size in cells
+ * @memberof MazeComplex
+ */
+void MazeComplex::placeRoom(int sX, int sY, int width, int height){
+    int roomIndex = structureCount++;
+    MazeStructure* roomStruct = new (&structures[roomIndex]) MazeStructure(width, height, sX, sY);
+    roomStruct->structure = ROOM;
+
+    // Update all cells in the room to point to the new room structure
+    for (int y = sY; y < sY + height; y++){
+        for (int x = sX; x < sX + width; x++){
+            int cellIndex = y * numCellX + x;
+            Uint8 boundary = 0;
+            if (x == sX) boundary |= directionBit(WEST);
+            if (x == sX + width - 1) boundary |= directionBit(EAST);
+            if (y == sY) boundary |= directionBit(NORTH);
+            if (y == sY + height - 1) boundary |= directionBit(SOUTH);
+            maze[cellIndex].parentStructure = roomIndex;
+            cellBoundary[cellIndex] = boundary;
+            cellWalls[cellIndex] = boundary;
         }
     }
 }
@@ -383,29 +420,37 @@ void MazeComplex::addRoom(int width, int height){
  */
 void MazeComplex::lookahead(Uint32 currentTime){
     if (!frontier.empty()){
-        int randomIndex = std::rand() % frontier.size();
-        auto it = frontier.begin();
-        std::advance(it, randomIndex);
-        int cell = *it;
-        frontier.erase(it);
+        visitFrontierCell(std::rand() % frontier.size(), currentTime);
+    }
+}
 
-        maze[cell].visited = true;
-        maze[cell].generationTime = currentTime;
-        
-        // Calculate individual cell position even if part of a room
-        int gridX = maze[cell].gridX;
-        int gridY = maze[cell].gridY;
-        int distance = calculateDistance(startX, startY, gridX, gridY);
-        maze[cell].distance = distance;
-        
-        // Choose a visited neighbor to connect to
-        chooseWallCandidate(cell);
-        
-        // Add unvisited neighbors to frontier (avoiding duplicates)
-        std::vector<int> unVisited = getNeighbors(maze[cell], false);
-        for(int neighbor : unVisited) {
-            frontier.insert(neighbor);
-        }
+/**
+ * @name visitFrontierCell
+ * @brief One step of Prim's algorithm, shared by lookahead and generateCompleteMaze. Takes the
+ * frontier cell at randomIndex (O(1), see Frontier), connects it to the maze and pushes its
+ * unvisited neighbors onto the frontier.
+ * @param randomIndex - position in the frontier, in [0, frontier.size())
+ * @param currentTime - generation time stamped on the cell
+ * @memberof MazeComplex
+ */
+void MazeComplex::visitFrontierCell(int randomIndex, Uint32 currentTime){
+    int cell = frontier.takeAt(randomIndex);
+
+    maze[cell].visited = true;
+    maze[cell].generationTime = (int) currentTime;
+    markDirty(cell, DIRTY_COLOR);
+
+    // Choose a visited neighbor to connect to, this also sets the cell's path distance
+    chooseWallCandidate(cell);
+    addToDistanceBucket(cell);
+    lod.addVisited(maze[cell].gridX, maze[cell].gridY, pathDistance[cell]);
+    trackRoomReveal(cell, currentTime);
+
+    // Add unvisited neighbors to frontier (the frontier ignores duplicates)
+    int unVisited[4];
+    int count = getNeighbors(maze[cell], false, unVisited);
+    for (int i = 0; i < count; i++) {
+        frontier.insert(unVisited[i]);
     }
 }
 
@@ -413,21 +458,86 @@ void MazeComplex::lookahead(Uint32 currentTime){
  * @name chooseWallCandidate
  * @brief This function gets the neighbors of a froniter cell and chooses a visited neighbor.
  * A frontier cell will "always" have a connected neighbor that is visited.
+ * The maze is a tree, so the path distance from the start is just the parent's distance + 1.
+ * We record it here instead of running a BFS once generation finishes.
  * @param frontierCell
  * @memberof MazeComplex
  */
 void MazeComplex::chooseWallCandidate(int frontierCell){
-    MazeElement element = maze[frontierCell];
-    std::vector<int> visited = getNeighbors(element, true);
-    if (!visited.empty()){
-        int connectVisitor = visited[std::rand() % visited.size()];
+    const MazeElement& element = maze[frontierCell];
+    int visited[4];
+    int count = getNeighbors(element, true, visited);
+    if (count > 0){
+        int connectVisitor = visited[std::rand() % count];
         removeWall(frontierCell, connectVisitor);
+        Uint32 depth = pathDistance[connectVisitor] + 1;
+        pathDistance[frontierCell] = depth;
+        maxDistance = std::max(maxDistance, (int) depth);
+    }
+}
+
+/**
+ * @name trackRoomReveal
+ * @brief Called once per newly visited cell. If the cell is on a room's perimeter, bump the room's
+ * visited counter, the room is revealed when the counter reaches the number of perimeter cells.
+ * This replaces rescanning every room's perimeter on every frame.
+ * @param cell - index of the cell that was just visited
+ * @param currentTime - generation time stamped on the revealed cells
+ * @memberof MazeComplex
+ */
+void MazeComplex::trackRoomReveal(int cell, Uint32 currentTime){
+    int roomIndex = maze[cell].parentStructure;
+    if (roomIndex == NO_STRUCTURE || cellBoundary[cell] == 0) {
+        return;
+    }
+    MazeStructure& room = structures[roomIndex];
+    room.perimeterVisited++;
+    if (room.perimeterVisited == room.perimeterSize) {
+        revealRoom(room, currentTime);
+    }
+}
+
+/**
+ * @name revealRoom
+ * @brief Marks the room revealed and visits its interior in one go, so from here on the renderer
+ * treats the whole room like any other visited cells. Interior cells can't connect to anything
+ * (no boundary bits), so marking them visited doesn't affect generation. Their path distance is the
+ * room's closest entry plus how deep the cell sits inside the room, which makes the color wave
+ * flow inward from the walls.
+ * @param room - MazeStructure of type ROOM whose perimeter is fully visited
+ * @param currentTime - generation time for the interior cells
+ * @memberof MazeComplex
+ */
+void MazeComplex::revealRoom(MazeStructure& room, Uint32 currentTime){
+    room.visited = true;
+    Uint32 entryDepth = UINT32_MAX;
+    for (int y = 0; y < room.height; y++){
+        for (int x = 0; x < room.width; x++){
+            int cellIndex = (room.startY + y) * numCellX + room.startX + x;
+            if (cellBoundary[cellIndex] != 0) {
+                entryDepth = std::min(entryDepth, pathDistance[cellIndex]);
+            }
+        }
+    }
+    for (int y = 1; y < room.height - 1; y++){
+        for (int x = 1; x < room.width - 1; x++){
+            int cellIndex = (room.startY + y) * numCellX + room.startX + x;
+            int inset = std::min(std::min(x, room.width - 1 - x), std::min(y, room.height - 1 - y));
+            Uint32 depth = entryDepth + inset;
+            pathDistance[cellIndex] = depth;
+            maxDistance = std::max(maxDistance, (int) depth);
+            maze[cellIndex].visited = true;
+            maze[cellIndex].generationTime = (int) currentTime;
+            addToDistanceBucket(cellIndex);
+            lod.addVisited(room.startX + x, room.startY + y, depth);
+            markDirty(cellIndex, DIRTY_COLOR);
+        }
     }
 }
 
 /**
  * @name removeWall
- * @brief Get the x and y positions of two cells, and mark the perimeter walls as visited = false
+ * @brief Get the x and y positions of two cells, and clear the walls between them
  * @param cell1
  * @param cell2
  * @memberof MazeComplex
@@ -459,27 +569,22 @@ void MazeComplex::removeWall(int cell1, int cell2) {
 /**
  * @name checkCell
  * @brief We have to mark the wall of one cell as removed and the opposite one on the other cell.
+ * Clearing a bit that isn't set is a no-op, which covers room cells that aren't on that edge.
+ * Each cell draws its own walls, so both need a redraw. Walls that actually came down leave the LOD pyramid.
  * @param direction
  * @param one
  * @param two
  * @memberof MazeComplex
  */
 void MazeComplex::checkCell(Direction direction, int one, int two){
-    auto cellOne = maze[one].parentStructure;
-    auto cellTwo = maze[two].parentStructure;
-    
-    for (auto& perim: cellOne->perimeterCells){
-        if (perim.cell == one && perim.direction == direction){
-            perim.visited = false;
-            break;
-        }
-    }
-    Direction oppositeDir = getOppositeDirection(direction);
-    for (auto& perim: cellTwo->perimeterCells){
-        if (perim.cell == two && perim.direction == oppositeDir){
-            perim.visited = false;
-            break;
+    Uint8 bits[2] = {directionBit(direction), directionBit(getOppositeDirection(direction))};
+    int cells[2] = {one, two};
+    for (int i = 0; i < 2; i++) {
+        if (cellWalls[cells[i]] & bits[i]) {
+            cellWalls[cells[i]] &= (Uint8) ~bits[i];
+            lod.removeWall(maze[cells[i]].gridX, maze[cells[i]].gridY);
         }
+        markDirty(cells[i], DIRTY_WALLS);
     }
 }
 
@@ -504,116 +609,797 @@ Direction MazeComplex::getOppositeDirection(Direction direction){
 }
 
 
-void MazeComplex::drawRectangle(Uint32* &pixelBuffer, int x, int y, int w, int h, const Uint32 & color) {
-    for (int sub_h = 0; sub_h < h; sub_h++) {
-        for (int sub_w =0; sub_w < w; sub_w++) {
-            int pixelX = x + sub_w;
-            int pixelY = y + sub_h;
-            if (pixelX < game->app.screenWidth && pixelY < game->app.screenHeight) {
-                pixelBuffer[pixelY * game->app.screenWidth + pixelX] = color;
+/**
+ * @name markDirty
+ * @brief Records that a cell changed since the last frame. Each cell is listed once, the flags say
+ * what changed so the cell renderer can skip the wall overlay when only the color moved.
+ * @param cell - index of the changed cell
+ * @param flags - DIRTY_COLOR and/or DIRTY_WALLS
+ * @memberof MazeComplex
+ */
+void MazeComplex::markDirty(int cell, Uint8 flags){
+    if (!cellDirty[cell]) {
+        dirtyCells[dirtyCount++] = cell;
+    }
+    cellDirty[cell] |= flags;
+}
+
+/**
+ * @name addToDistanceBucket
+ * @brief Files a newly visited cell under its path distance. A cell's distance never changes once
+ * it's visited, so the buckets only ever grow and insertion is O(1).
+ * @param cell - index of the visited cell, its path distance must already be set
+ * @memberof MazeComplex
+ */
+void MazeComplex::addToDistanceBucket(int cell){
+    Uint32 distance = pathDistance[cell];
+    if (distance >= distanceHead.size()) {
+        distanceHead.resize(distance + 1, -1);
+        distanceCount.resize(distance + 1, 0);
+    }
+    nextAtDistance[cell] = distanceHead[distance];
+    distanceHead[distance] = cell;
+    distanceCount[distance]++;
+}
+
+/**
+ * @name advanceColorLut
+ * @brief Moves the LUT on to this frame, keeping the last frame's in previousLut. isFrameStatic may have
+ * built it already for the same time.
+ * @param currentTime
+ * @memberof MazeComplex
+ */
+void MazeComplex::advanceColorLut(Uint32 currentTime){
+    if (lutPrebuilt && lutPrebuiltTime == currentTime) {
+        lutPrebuilt = false;
+        return;
+    }
+    lutPrebuilt = false;
+    std::swap(colorLut, previousLut);
+    buildColorLut(currentTime);
+}
+
+/**
+ * @name isFrameStatic
+ * @brief Whether this frame would draw exactly what is on screen already: nothing was carved, revealed
+ * or reconfigured since the last frame, the camera and angle haven't moved, and the colors the wave
+ * gives for currentTime are the ones drawn last time. A disabled wave with a zero time coefficient
+ * never changes; a running one can still land on the same packed colors.
+ * The LUT built for the check is kept, so a frame that does change doesn't build it twice.
+ * @param currentTime - time the frame would be drawn with, as passed to displayMazeComplex
+ * @return bool - true when drawing and presenting can be skipped
+ * @memberof MazeComplex
+ */
+bool MazeComplex::isFrameStatic(Uint32 currentTime){
+    if (!presentCurrent || dirtyCount > 0 || game->renderConfig.angle != presentedAngle) {
+        return false;
+    }
+    CellViewport visible = game->camera.viewport(pixelSize, numCellX, numCellY, game->app.screenWidth,
+        game->app.screenHeight);
+    if (visible != view) {
+        return false;
+    }
+    std::swap(colorLut, previousLut);
+    buildColorLut(currentTime);
+    lutPrebuilt = true;
+    lutPrebuiltTime = currentTime;
+    return colorLut == previousLut;
+}
+
+/**
+ * @name getIdleTimeout
+ * @brief How long the loop may sleep on a static frame before the maze changes on its own. Only a
+ * finished instant maze does, when its display time runs out; a maze generating cell by cell never
+ * has static frames.
+ * @param simulationTime - current simulation time, the clock updateMazeComplex runs on
+ * @return int - milliseconds, -1 when only input can change anything
+ * @memberof MazeComplex
+ */
+int MazeComplex::getIdleTimeout(Uint32 simulationTime) const{
+    if (!mazeComplete || mazeCompletionTime == 0 || game->renderConfig.renderByFrame) {
+        return -1;
+    }
+    Uint32 shown = simulationTime - mazeCompletionTime;
+    return shown > mazeDisplayTime ? 0 : (int) (mazeDisplayTime - shown) + 1;
+}
+
+/**
+ * @name refreshColorLut
+ * @brief Rebuilds the color LUT for this frame and marks the visible cells whose color changed since
+ * the last one. That covers the wave moving as well as color edits in the UI.
+ * The LUT is the palette and path distance is each cell's index into it, so animating the wave costs
+ * O(palette) to rebuild it plus a walk over the distance buckets of the entries that changed. Cells on
+ * unchanged entries are never looked at. When the changed buckets hold more cells than the viewport
+ * (a big maze with the wave running), scanning the viewport is cheaper. While the wave is static
+ * nothing is marked and the frame only pays for what generation changed.
+ * @param currentTime
+ * @memberof MazeComplex
+ */
+void MazeComplex::refreshColorLut(Uint32 currentTime){
+    advanceColorLut(currentTime);
+    if (fullRedraw) {
+        return;
+    }
+
+    // Distances new this frame only belong to cells that were just carved, they're dirty already
+    int compared = std::min({colorLut.size(), previousLut.size(), distanceHead.size()});
+    long long changed = 0;
+    for (int d = 0; d < compared; d++) {
+        if (colorLut[d] != previousLut[d]) {
+            changed += distanceCount[d];
+        }
+    }
+    if (changed == 0) {
+        return;
+    }
+    if (changed > (long long) view.width() * view.height()) {
+        for (int y = view.y0; y < view.y1; y++) {
+            for (int cell = y * numCellX + view.x0; cell < y * numCellX + view.x1; cell++) {
+                Uint32 d = pathDistance[cell];
+                if (maze[cell].visited && d < (Uint32) compared && colorLut[d] != previousLut[d]) {
+                    markDirty(cell, DIRTY_COLOR);
+                }
+            }
+        }
+        return;
+    }
+    for (int d = 0; d < compared; d++) {
+        if (colorLut[d] == previousLut[d]) {
+            continue;
+        }
+        for (int cell = distanceHead[d]; cell != -1; cell = nextAtDistance[cell]) {
+            if (view.contains(maze[cell].gridX, maze[cell].gridY)) {
+                markDirty(cell, DIRTY_COLOR);
+            }
+        }
+    }
+}
+
+/**
+ * @name framebufferTarget
+ * @brief The CPU framebuffer as a fill target, it matches the screen size. In cell mode it only holds
+ * the wall overlay.
+ * @return PixelTarget
+ * @memberof MazeComplex
+ */
+PixelTarget MazeComplex::framebufferTarget(){
+    return {framebuffer.data(), game->app.screenWidth, game->app.screenHeight, game->app.screenWidth};
+}
+
+/**
+ * @name cellColor
+ * @brief Packed color of a cell for this frame, LUT color once visited, background before
+ * @param cell - index of the cell
+ * @return Uint32
+ * @memberof MazeComplex
+ */
+Uint32 MazeComplex::cellColor(int cell){
+    return maze[cell].visited ? colorLut[pathDistance[cell]] : backgroundValue;
+}
+
+/**
+ * @name drawCell
+ * @brief Fills a cell's box and draws its standing walls on the box edges. The box comes from the
+ * camera mapping of the area being drawn, cells squashed to nothing are skipped.
+ * @param target - where to draw
+ * @param area - maps cells to target pixels
+ * @param cell - index of the cell
+ * @param fill - packed fill color
+ * @param walls - false leaves the walls to the GPU
+ * @memberof MazeComplex
+ */
+void MazeComplex::drawCell(const PixelTarget& target, const CellViewport& area, int cell, Uint32 fill, bool walls){
+    const MazeElement& element = maze[cell];
+    int x = area.edgeX(element.gridX);
+    int y = area.edgeY(element.gridY);
+    int w = area.edgeX(element.gridX + 1) - x;
+    int h = area.edgeY(element.gridY + 1) - y;
+    if (w <= 0 || h <= 0 || x >= target.width || y >= target.height) {
+        return;
+    }
+    fillRect(target, x, y, w, h, fill);
+    if (!walls) {
+        return;
+    }
+
+    Uint8 cellWall = cellWalls[cell];
+    if (cellWall & directionBit(NORTH)) {
+        fillHLine(target, x, y, w, wallColorValue);
+    }
+    if (cellWall & directionBit(EAST)) {
+        fillVLine(target, x + w - 1, y, h, wallColorValue);
+    }
+    if (cellWall & directionBit(SOUTH)) {
+        fillHLine(target, x, y + h - 1, w, wallColorValue);
+    }
+    if (cellWall & directionBit(WEST)) {
+        fillVLine(target, x, y, h, wallColorValue);
+    }
+}
+
+/**
+ * @name rasterizeCell
+ * @brief Draws one cell. Walls sit inside the cell's own pixel box, so a cell never touches its
+ * neighbors' pixels. The box comes from the camera, cells outside the viewport are skipped.
+ * Pixel mode: the fill and whichever walls are still standing go into the framebuffer.
+ * Cell mode: the color is one texel of the cell texture, the walls are redrawn into the transparent
+ * overlay only when they changed.
+ * With GPU walls the walls are skipped here, see WallGeometry.
+ * @param cell - index of the cell
+ * @param flags - what changed, DIRTY_COLOR and/or DIRTY_WALLS
+ * @memberof MazeComplex
+ */
+void MazeComplex::rasterizeCell(int cell, Uint8 flags){
+    const MazeElement& element = maze[cell];
+    if (!view.contains(element.gridX, element.gridY)) {
+        return;
+    }
+    if (renderMode == RENDER_CELL) {
+        if (flags & DIRTY_COLOR) {
+            size_t texel = (size_t) (element.gridY - view.y0) * view.width() + (element.gridX - view.x0);
+            cellPixels[texel] = cellColor(cell);
+        }
+        if (gpuWalls || !(flags & DIRTY_WALLS)) {
+            return;
+        }
+    } else if (gpuWalls && !(flags & DIRTY_COLOR)) {
+        return;
+    }
+    Uint32 fill = renderMode == RENDER_CELL ? TRANSPARENT_PIXEL : cellColor(cell);
+    drawCell(framebufferTarget(), view, cell, fill, !gpuWalls);
+}
+
+/**
+ * @name rasterizeTile
+ * @brief Draws one cache tile from scratch: background, then every cell it covers with its walls.
+ * Tiles at levels where cells are under a pixel are drawn from the LOD pyramid instead. Also records the tile's distance range so color changes elsewhere in the LUT leave it alone.
+ * Touches nothing shared, tiles are rasterized in parallel.
+ * @param tile - tile to draw, its level and position pick the cells
+ * @param pixels - tileSize x tileSize output
+ * @param columns, colors - the tile's own overview scratch, tileSize + 1 entries each
+ * @memberof MazeComplex
+ */
+void MazeComplex::rasterizeTile(Tile& tile, Uint32* pixels, int* columns, Uint32* colors){
+    const int size = TileCache::tileSize;
+    double zoom = std::ldexp(1.0, tile.key.level);
+    CellViewport area = CellViewport::covering(pixelSize, zoom, tile.key.x * size / zoom, tile.key.y * size / zoom,
+        numCellX, numCellY, size, size);
+    PixelTarget target{pixels, size, size, size};
+    Uint32 minDistance = UINT32_MAX, maxDistance = 0;
+    int level = lod.levelFor(1.0 / (pixelSize * zoom));
+    if (level > 0) {
+        drawOverview(target, area, level, mapOverviewColumns(area, level, size, columns), colors, 0, size,
+            minDistance, maxDistance);
+        tile.minDistance = minDistance;
+        tile.maxDistance = maxDistance;
+        return;
+    }
+    fillRect(target, 0, 0, size, size, backgroundValue);
+    for (int y = area.y0; y < area.y1; y++) {
+        for (int cell = y * numCellX + area.x0; cell < y * numCellX + area.x1; cell++) {
+            if (maze[cell].visited) {
+                minDistance = std::min(minDistance, pathDistance[cell]);
+                maxDistance = std::max(maxDistance, pathDistance[cell]);
             }
+            drawCell(target, area, cell, cellColor(cell), true);
         }
     }
+    tile.minDistance = minDistance;
+    tile.maxDistance = maxDistance;
 }
 
+/**
+ * @name rasterizeBand
+ * @brief Full redraw of one horizontal band: a slice of the viewport's cell rows, plus whatever lies
+ * around the grid for the first and last band (background in pixel mode, transparent overlay in cell mode).
+ * Bands never share pixels, so they can be drawn in parallel.
+ * @param band - index of this band
+ * @param bandCount - number of bands the frame is split into
+ * @memberof MazeComplex
+ */
+void MazeComplex::rasterizeBand(int band, int bandCount){
+    int screenHeight = game->app.screenHeight;
+    int firstRow = view.y0 + view.height() * band / bandCount;
+    int lastRow = view.y0 + view.height() * (band + 1) / bandCount;
+    int top = band == 0 ? 0 : std::clamp(view.edgeY(firstRow), 0, screenHeight);
+    int bottom = band == bandCount - 1 ? screenHeight : std::clamp(view.edgeY(lastRow), 0, screenHeight);
+    // Cell mode with GPU walls has no overlay to clear
+    if ((renderMode == RENDER_PIXEL || !gpuWalls) && bottom > top) {
+        Uint32 clear = renderMode == RENDER_CELL ? TRANSPARENT_PIXEL : backgroundValue;
+        fillRect(framebufferTarget(), 0, top, game->app.screenWidth, bottom - top, clear);
+    }
+    for (int y = firstRow; y < lastRow; y++) {
+        for (int cell = y * numCellX + view.x0; cell < y * numCellX + view.x1; cell++) {
+            rasterizeCell(cell, DIRTY_COLOR | DIRTY_WALLS);
+        }
+    }
+}
 
+/**
+ * @name rasterizeDirty
+ * @brief Redraws the dirty cells. Cells own disjoint pixel boxes, so a large dirty list (a finished
+ * instant maze, a color wave sweep) is split into chunks across the raster pool.
+ * @memberof MazeComplex
+ */
+void MazeComplex::rasterizeDirty(){
+    int threads = rasterPool->getThreadCount();
+    int chunks = dirtyCount >= parallelRasterCells ? threads * 4 : 1;
+    rasterPool->parallelFor(chunks, [this, chunks](int chunk) {
+        int begin = (int) ((long long) dirtyCount * chunk / chunks);
+        int end = (int) ((long long) dirtyCount * (chunk + 1) / chunks);
+        for (int i = begin; i < end; i++) {
+            rasterizeCell(dirtyCells[i], cellDirty[dirtyCells[i]]);
+        }
+    });
+}
+
+/**
+ * @name collectDirtyRects
+ * @brief Turns the dirty cells matching mask into upload rectangles. Each cell row gets the
+ * span between its leftmost and rightmost dirty cell, consecutive dirty rows are merged into one
+ * rectangle. A single carve step ends up as one small rectangle. Only cells in the viewport count.
+ * @param mask - which dirty flags count
+ * @param screenSpace - true for the screen textures (camera mapped pixels, clipped to the window),
+ * false for the cell texture (one texel per viewport cell)
+ * @param rects - output, appended to
+ * @memberof MazeComplex
+ */
+void MazeComplex::collectDirtyRects(Uint8 mask, bool screenSpace, std::vector<SDL_Rect>& rects){
+    rowMinX.assign(view.height(), view.x1);
+    rowMaxX.assign(view.height(), -1);
+    for (int i = 0; i < dirtyCount; i++) {
+        int cell = dirtyCells[i];
+        int x = maze[cell].gridX, y = maze[cell].gridY;
+        if (!(cellDirty[cell] & mask) || !view.contains(x, y)) {
+            continue;
+        }
+        rowMinX[y - view.y0] = std::min(rowMinX[y - view.y0], x);
+        rowMaxX[y - view.y0] = std::max(rowMaxX[y - view.y0], x);
+    }
+
+    int limitW = screenSpace ? game->app.screenWidth : view.width();
+    int limitH = screenSpace ? game->app.screenHeight : view.height();
+    for (int row = 0; row < view.height(); row++) {
+        if (rowMaxX[row] < 0) {
+            continue;
+        }
+        int firstRow = row;
+        int minX = rowMinX[row], maxX = rowMaxX[row];
+        while (row + 1 < view.height() && rowMaxX[row + 1] >= 0) {
+            row++;
+            minX = std::min(minX, rowMinX[row]);
+            maxX = std::max(maxX, rowMaxX[row]);
+        }
+        SDL_Rect rect;
+        if (screenSpace) {
+            int left = view.edgeX(minX), top = view.edgeY(view.y0 + firstRow);
+            int right = view.edgeX(maxX + 1), bottom = view.edgeY(view.y0 + row + 1);
+            left = std::max(left, 0);
+            top = std::max(top, 0);
+            rect = {left, top, right - left, bottom - top};
+        } else {
+            rect = {minX - view.x0, firstRow, maxX - minX + 1, row - firstRow + 1};
+        }
+        rect.w = std::min(rect.w, limitW - rect.x);
+        rect.h = std::min(rect.h, limitH - rect.y);
+        if (rect.w > 0 && rect.h > 0) {
+            rects.push_back(rect);
+        }
+    }
+}
+
+/**
+ * @name clearDirty
+ * @brief Empties the dirty list once the frame has been drawn
+ * @memberof MazeComplex
+ */
+void MazeComplex::clearDirty(){
+    for (int i = 0; i < dirtyCount; i++) {
+        cellDirty[dirtyCells[i]] = 0;
+    }
+    dirtyCount = 0;
+}
+
+/**
+ * @name ensureCellTexture
+ * @brief Cell mode draws from a texture with one texel per visible cell, scaled up by the renderer with
+ * nearest filtering so cells stay sharp. The texture is sized in steps of 64 texels and only swapped
+ * for a bigger pooled one when the viewport outgrows it, so panning and zooming don't churn textures.
+ * The outgrown textures are destroyed right away. Handed back to the pool outside cell mode.
+ * @memberof MazeComplex
+ */
+void MazeComplex::ensureCellTexture(){
+    if (renderMode != RENDER_CELL) {
+        cellRing.release(game->texturePool);
+        return;
+    }
+    cellPixels.resize((size_t) view.width() * view.height());
+    if (cellRing.getSlotCount() > 0 && cellRing.getWidth() >= view.width() && cellRing.getHeight() >= view.height()) {
+        return;
+    }
+    int width = std::max(cellRing.getWidth(), (std::max(view.width(), 1) + 63) / 64 * 64);
+    int height = std::max(cellRing.getHeight(), (std::max(view.height(), 1) + 63) / 64 * 64);
+    bool growing = cellRing.getSlotCount() > 0;
+    cellRing.acquire(game->texturePool, game->app.renderer, pixelFormatFor(game->pixelLayout), width, height,
+        game->renderConfig.streamingTextures);
+    cellRing.setScaleMode(SDL_ScaleModeNearest);
+    // The ring only grows, the textures it just outgrew would sit idle in the pool until the next mode change
+    if (growing) {
+        game->texturePool.trim();
+    }
+}
 
 /**
  * @name displayMazeComplex
- * @brief Our rendering function. Two main loops:
- * 1. First, draw the color shift for any visited cell. The color is generated using settings from ImGui
- * 2. Second, we draw the original color of the cells, which is a white color. These are drawn as small slices.
- * 3. The background color fills in anything that's not visited that's left over. It's a dark grey black.
- * This is an expensive operation, because of all the SDL_RenderFillRect calls. We can make it more efficient
- * by creating a texture and drawing to that one directly for all calls.
+ * @brief Our rendering function. The maze is kept rasterized on the CPU, and only the damage
+ * since the last frame is redrawn:
+ * 1. Ask the camera which cells are on screen. Only those are ever touched, so the cost of a frame
+ *    follows the window size, not the maze size. A pan or zoom moves every visible cell and repaints the viewport.
+ * 2. Rebuild the per-distance color LUT, visible cells whose color moved are marked dirty.
+ * 3. Rasterize the dirty cells (carved cells, both sides of a removed wall, revealed rooms).
+ *    Big jobs are split over the raster thread pool: row bands for a full redraw, chunks of the dirty list otherwise.
+ *    Visited cells get their LUT color, everything else the dark grey black background, then the white walls.
+ * 4. Upload only the dirty rectangles, into the next texture of a TextureRing so the upload doesn't wait
+ *    on the GPU still drawing last frame's. That texture also catches up on the rects it missed.
+ * Pixel mode draws each visible cell's box into one screen sized image.
+ * Cell mode writes one texel per visible cell and lets the renderer scale it up, the walls come from a
+ * transparent overlay (screenRing) that only changes on carve.
+ * With GPU walls (the default) neither mode rasterizes walls: the rows and columns of cells whose walls
+ * changed are re-emitted into WallGeometry and all walls are drawn with one SDL_RenderGeometry call.
+ * Tiled mode goes through displayTiles instead, and once cells are smaller than a pixel the other modes
+ * switch to displayOverview.
+ * A new texture, cell size or render mode change repaints and uploads everything once.
+ * Without a renderer (headless) only the rasterizing happens: pixel mode with CPU walls leaves the finished
+ * image in the framebuffer, unrotated.
  * @param currentTime
  */
 void MazeComplex::displayMazeComplex(Uint32 currentTime) {
-    SDL_SetRenderDrawColor(game->app.renderer, background.r, background.g, background.b, background.a);
-    SDL_RenderClear(game->app.renderer);
-    void* pixels;
-    int pitch;
+    if (game->app.renderer) {
+        SDL_SetRenderDrawColor(game->app.renderer, background.r, background.g, background.b, background.a);
+        SDL_RenderClear(game->app.renderer);
+    }
     float angle = game->renderConfig.angle;
-    if (SDL_LockTexture(mazeTexture, nullptr, &pixels, &pitch) == 0) {
-        auto* pixel_buffer = (Uint32*)pixels;
-        // Draw color shift
-        for (const auto& mazeElem : maze) {
-            auto structure = mazeElem.parentStructure;
-            if (mazeElem.visited) {
-                SDL_Color color = generateColor(mazeElem.distance, currentTime);
-                Uint32 colorValue = (color.a << 24) | (color.r << 16) | (color.g << 8) | color.b;
-                drawRectangle(pixel_buffer, mazeElem.gridX * pixelSize,
-                    mazeElem.gridY * pixelSize, pixelSize, pixelSize, colorValue);
-            }else if (structure->structure == ROOM){
-                bool allperimeter_elems_covered = true;
-                for(auto e: structure->perimeterCells){
-                    MazeElement elem = maze[e.cell];
-                    if (!elem.visited){
-                        allperimeter_elems_covered = false;
-                    }
-                }
-                if (allperimeter_elems_covered) {
-                    int sX = structure->startX;
-                    int sY = structure->startY;
-                    int height = structure->height;
-                    int width = structure->width;
-
-                    for (int y = sY; y < sY + height; y++){
-                        for (int x = sX; x < sX + width; x++){
-                            int cellIndex = y * numCellX + x;
-                            auto cellElem = maze[cellIndex];
-                            SDL_Color color = generateColor(cellElem.distance, currentTime);
-                            Uint32 colorValue = (color.a << 24) | (color.r << 16) | (color.g << 8) | color.b;
-                            int x_point = mazeElem.gridX * pixelSize;
-                            int y_point = mazeElem.gridY * pixelSize;
-                            drawRectangle(pixel_buffer, x_point, y_point, pixelSize, pixelSize, colorValue);
-                        }
-                    }
+    int screenWidth = game->app.screenWidth;
+    int screenHeight = game->app.screenHeight;
+    // Whichever path runs below leaves the screen matching the maze
+    presentCurrent = true;
+    presentedAngle = angle;
+
+    if (!rasterPool) {
+        rasterPool = std::make_unique<ThreadPool>();
+    }
+
+    game->frameTimer.begin(PHASE_RASTER);
+    CellViewport visible = game->camera.viewport(pixelSize, numCellX, numCellY, screenWidth, screenHeight);
+    if (renderMode == RENDER_TILED) {
+        view = visible;
+        displayTiles(currentTime);
+        return;
+    }
+    overviewLevel = lod.levelFor(1.0 / (pixelSize * visible.zoom));
+    if (overviewLevel > 0) {
+        view = visible;
+        displayOverview(currentTime);
+        return;
+    }
+    if (visible != view) {
+        view = visible;
+        fullRedraw = true;
+    }
+    if (renderMode == RENDER_CELL) {
+        ensureCellTexture();
+    }
+    refreshColorLut(currentTime);
+    dirtyRects.clear();
+    cellRects.clear();
+    if (fullRedraw) {
+        int threads = rasterPool->getThreadCount();
+        int bands = (long long) view.width() * view.height() >= parallelRasterCells ? threads * 4 : 1;
+        rasterPool->parallelFor(bands, [this, bands](int band) { rasterizeBand(band, bands); });
+        if (renderMode == RENDER_PIXEL || !gpuWalls) {
+            dirtyRects.push_back({0, 0, screenWidth, screenHeight});
+        }
+        if (view.width() > 0 && view.height() > 0) {
+            cellRects.push_back({0, 0, view.width(), view.height()});
+        }
+        if (gpuWalls) {
+            wallGeometry.reset(view, numCellX, wallColor);
+        }
+        fullRedraw = false;
+    } else if (dirtyCount > 0) {
+        rasterizeDirty();
+        Uint8 screenMask = renderMode == RENDER_CELL ? DIRTY_WALLS : DIRTY_COLOR | DIRTY_WALLS;
+        if (gpuWalls) {
+            screenMask &= (Uint8) ~DIRTY_WALLS;
+            for (int i = 0; i < dirtyCount; i++) {
+                const MazeElement& element = maze[dirtyCells[i]];
+                if (cellDirty[element.place] & DIRTY_WALLS) {
+                    wallGeometry.markCell(element.gridX, element.gridY);
                 }
-            }else{
-                Uint32 colorValue = (background.a << 24) | (background.r << 16) | (background.g << 8) | background.b;
-                // Fill the corresponding pixels in the texture
-                drawRectangle(pixel_buffer, mazeElem.gridX * pixelSize,
-                    mazeElem.gridY * pixelSize, pixelSize, pixelSize, colorValue);
             }
         }
-        Uint32 wallColorValue = (wallColor.a << 24) | (wallColor.r << 16) | (wallColor.g << 8) | wallColor.b;
-        for (int i = 0; i < numCellX * numCellY; i++) {
-            const MazeElement& element = maze[i];
-            int x = element.gridX * pixelSize;
-            int y = element.gridY * pixelSize;
-
-            // Check perimeter cells for walls to draw
-            auto structure = element.parentStructure;
-            if (structure) {
-                for (const auto& perimCell : structure->perimeterCells) {
-                    if (perimCell.cell == element.place && perimCell.visited) {
-                        // Draw wall based on direction
-                        switch (perimCell.direction) {
-                            case NORTH: {
-                                drawRectangle(pixel_buffer, x, y, pixelSize, 1, wallColorValue);
-                                break;
-                            }
-                            case EAST: {
-                                drawRectangle(pixel_buffer, x+pixelSize - 1, y, 1, pixelSize, wallColorValue);
-                                break;
-                            }
-                            case SOUTH: {
-                                drawRectangle(pixel_buffer, x, y + pixelSize - 1, pixelSize, 1, wallColorValue);
-                                break;
-                            }
-                            case WEST: {
-                                drawRectangle(pixel_buffer, x, y, 1, pixelSize, wallColorValue);
-                                break;
-                            }
-                        }
-                    }
-                }
+        if (screenMask) {
+            collectDirtyRects(screenMask, true, dirtyRects);
+        }
+        if (renderMode == RENDER_CELL) {
+            collectDirtyRects(DIRTY_COLOR, false, cellRects);
+        }
+    }
+    clearDirty();
+    if (gpuWalls) {
+        wallGeometry.rebuild(cellWalls.begin());
+    }
+    game->frameTimer.end(PHASE_RASTER);
+
+    game->frameTimer.begin(PHASE_UPLOAD);
+    UploadMethod method = game->renderConfig.uploadMethod;
+    SDL_Texture* screenTexture = nullptr;
+    if (renderMode == RENDER_PIXEL || !gpuWalls) {
+        screenTexture = screenRing.upload(framebuffer.data(), screenWidth, screenHeight, dirtyRects, method);
+    }
+    SDL_Texture* cellTexture = nullptr;
+    if (renderMode == RENDER_CELL) {
+        cellTexture = cellRing.upload(cellPixels.data(), view.width(), view.height(), cellRects, method);
+    }
+    game->frameTimer.end(PHASE_UPLOAD);
+
+    if (renderMode == RENDER_CELL && view.width() > 0 && view.height() > 0) {
+        // Only the viewport's corner of the texture is in use. Rotate around the screen center like
+        // the full screen overlay does
+        SDL_Rect source{0, 0, view.width(), view.height()};
+        float left = (float) view.edgeX(view.x0), top = (float) view.edgeY(view.y0);
+        SDL_FRect mazeRect{left, top, (float) view.edgeX(view.x1) - left, (float) view.edgeY(view.y1) - top};
+        SDL_FPoint center{(float) screenWidth / 2.0f - left, (float) screenHeight / 2.0f - top};
+        SDL_RenderCopyExF(game->app.renderer, cellTexture, &source, &mazeRect, angle, &center, SDL_FLIP_NONE);
+    }
+    if (screenTexture) {
+        SDL_RenderCopyEx(game->app.renderer, screenTexture, nullptr, nullptr, angle, nullptr, SDL_FLIP_NONE);
+    }
+    if (gpuWalls) {
+        SDL_FPoint center{(float) screenWidth / 2.0f, (float) screenHeight / 2.0f};
+        wallGeometry.draw(game->app.renderer, angle, center);
+    }
+}
+
+/**
+ * @name displayTiles
+ * @brief Tiled mode. The maze is cut into tileSize pixel tiles at the power of two zoom just below the
+ * camera's (see TileCache::levelForZoom), and the renderer stretches them the rest of the way:
+ * 1. Rebuild the color LUT. Tiles using LUT entries that changed, or holding cells that changed, go stale.
+ * 2. Look up the tiles covering the screen, missing ones are created stale.
+ * 3. Rasterize the stale on-screen tiles in parallel and upload them whole. Off-screen tiles stay stale
+ *    until they're needed again.
+ * 4. Draw every visible tile, rotated around the screen center like the other modes.
+ * Walls are baked into the tiles, so a pan or zoom without maze changes costs nothing but blits.
+ * @param currentTime
+ * @memberof MazeComplex
+ */
+void MazeComplex::displayTiles(Uint32 currentTime){
+    const int size = TileCache::tileSize;
+    int screenWidth = game->app.screenWidth;
+    int screenHeight = game->app.screenHeight;
+    float angle = game->renderConfig.angle;
+
+    tileCache.setBudget((size_t) game->renderConfig.tileBudgetMB << 20);
+    tileCache.beginFrame();
+    advanceColorLut(currentTime);
+    // Once the dirty list outnumbers the tiles (a finished instant maze), looking each cell up costs more
+    if (fullRedraw || dirtyCount > tileCache.getTileCount() * 64) {
+        tileCache.invalidateAll();
+        fullRedraw = false;
+    } else {
+        tileCache.invalidateDistances(colorLut, previousLut);
+        for (int i = 0; i < dirtyCount; i++) {
+            const MazeElement& element = maze[dirtyCells[i]];
+            tileCache.invalidateCell(element.gridX, element.gridY, pixelSize);
+        }
+    }
+    clearDirty();
+
+    int level = TileCache::levelForZoom(view.zoom);
+    double levelZoom = std::ldexp(1.0, level);
+    double tileScreen = size * view.zoom / levelZoom;
+    double originX = view.offsetX * view.zoom, originY = view.offsetY * view.zoom;
+    int tilesX = (int) std::ceil(getWorldWidth() * levelZoom / size);
+    int tilesY = (int) std::ceil(getWorldHeight() * levelZoom / size);
+    int firstX = std::max(0, (int) std::floor(originX / tileScreen));
+    int firstY = std::max(0, (int) std::floor(originY / tileScreen));
+    int lastX = std::min(tilesX - 1, (int) std::floor((originX + screenWidth - 1) / tileScreen));
+    int lastY = std::min(tilesY - 1, (int) std::floor((originY + screenHeight - 1) / tileScreen));
+    visibleTiles.clear();
+    staleTiles.clear();
+    for (int y = firstY; y <= lastY; y++) {
+        for (int x = firstX; x <= lastX; x++) {
+            Tile* tile = tileCache.acquire(game->texturePool, game->app.renderer, pixelFormatFor(game->pixelLayout),
+                {level, x, y});
+            if (!tile) {
+                continue;
             }
+            visibleTiles.push_back(tile);
+            if (tile->stale) {
+                staleTiles.push_back(tile);
+            }
+        }
+    }
+    tileScratch.resize(staleTiles.size() * size * size);
+    tileColumns.resize(staleTiles.size() * (size + 1));
+    tileColors.resize(staleTiles.size() * (size + 1));
+    rasterPool->parallelFor((int) staleTiles.size(), [this, size](int i) {
+        rasterizeTile(*staleTiles[i], &tileScratch[(size_t) i * size * size], &tileColumns[(size_t) i * (size + 1)],
+            &tileColors[(size_t) i * (size + 1)]);
+    });
+    game->frameTimer.end(PHASE_RASTER);
+
+    game->frameTimer.begin(PHASE_UPLOAD);
+    for (size_t i = 0; i < staleTiles.size(); i++) {
+        TextureRing::uploadRect(staleTiles[i]->texture, {0, 0, size, size}, &tileScratch[i * size * size], size,
+            game->renderConfig.uploadMethod);
+        staleTiles[i]->stale = false;
+    }
+    game->frameTimer.end(PHASE_UPLOAD);
 
+    for (Tile* tile : visibleTiles) {
+        SDL_FRect destination{(float) (tile->key.x * tileScreen - originX), (float) (tile->key.y * tileScreen - originY),
+            (float) tileScreen, (float) tileScreen};
+        SDL_FPoint center{(float) screenWidth / 2.0f - destination.x, (float) screenHeight / 2.0f - destination.y};
+        SDL_RenderCopyExF(game->app.renderer, tile->texture, nullptr, &destination, angle, &center, SDL_FLIP_NONE);
+    }
+    tileCache.endFrame(game->texturePool);
+}
 
+/**
+ * @name overviewColor
+ * @brief Color of one LOD block. The visited share of the block mixes the background toward the LUT
+ * color of the block's mean distance, so the wave keeps running zoomed out. The walls are then mixed in
+ * by the share of the cell they would cover: a standing wall is a 1 pixel line across a pixelSize cell.
+ * @param level - pyramid level
+ * @param blockX, blockY - block position in that level
+ * @return Uint32 - packed pixel
+ * @memberof MazeComplex
+ */
+Uint32 MazeComplex::overviewColor(int level, int blockX, int blockY){
+    const LodBlock& block = lod.block(level, blockX, blockY);
+    Uint64 cells = (Uint64) lod.blockCells(level, blockX, blockY);
+    Uint32 color = backgroundValue;
+    if (block.visited > 0) {
+        Uint32 lutColor = colorLut[block.distanceSum / block.visited];
+        color = mixColor(backgroundValue, lutColor, (Uint32) (block.visited * 256ull / cells));
+    }
+    Uint32 wallWeight = (Uint32) std::min<Uint64>(256, block.walls * 256ull / (cells * pixelSize));
+    return mixColor(color, wallColorValue, wallWeight);
+}
+
+/**
+ * @name mapOverviewColumns
+ * @brief Finds the pyramid block under every column of an overview target. Columns map to the same
+ * blocks on every row, so this is done once per target and shared by all of its row bands.
+ * @param area - maps world pixels to target pixels
+ * @param level - pyramid level
+ * @param width - target columns
+ * @param blocks - out, width entries
+ * @return OverviewColumns - blocks and the range of block columns they cover, at most width + 1 wide
+ * @memberof MazeComplex
+ */
+MazeComplex::OverviewColumns MazeComplex::mapOverviewColumns(const CellViewport& area, int level, int width,
+    int* blocks){
+    double cellsPerPixel = 1.0 / (area.cellSize * area.zoom);
+    double originX = area.offsetX / area.cellSize;
+    int blocksX = lod.getLevelWidth(level);
+    OverviewColumns columns{blocks, blocksX, -1};
+    for (int x = 0; x < width; x++) {
+        double cellX = originX + (x + 0.5) * cellsPerPixel;
+        int blockX = cellX < 0 || cellX >= numCellX ? -1 : std::min((int) cellX >> level, blocksX - 1);
+        blocks[x] = blockX;
+        if (blockX >= 0) {
+            columns.firstBlock = std::min(columns.firstBlock, blockX);
+            columns.lastBlock = std::max(columns.lastBlock, blockX);
+        }
+    }
+    return columns;
+}
+
+/**
+ * @name drawOverview
+ * @brief Draws rows of a target straight from the LOD pyramid, one block lookup per pixel, so the cost
+ * follows the pixel count however many cells there are. Pixels off the grid get the background.
+ * Neighboring rows usually share a block row, so block colors are worked out once per block row and
+ * looked up per pixel.
+ * @param target - where to draw
+ * @param area - maps world pixels to target pixels
+ * @param level - pyramid level, blocks of 2^level cells at least a pixel wide
+ * @param columns - from mapOverviewColumns for this target
+ * @param blockColor - scratch for one block row, the caller's own when drawing in parallel
+ * @param firstRow, lastRow - target rows to draw
+ * @param minDistance, maxDistance - widened to the mean distances that were drawn
+ * @memberof MazeComplex
+ */
+void MazeComplex::drawOverview(const PixelTarget& target, const CellViewport& area, int level,
+    const OverviewColumns& columns, Uint32* blockColor, int firstRow, int lastRow, Uint32& minDistance,
+    Uint32& maxDistance){
+    double cellsPerPixel = 1.0 / (area.cellSize * area.zoom);
+    double originY = area.offsetY / area.cellSize;
+    int blocksY = lod.getLevelHeight(level);
+    int firstBlock = columns.firstBlock, lastBlock = columns.lastBlock;
+    int colorRow = -1;
+    for (int y = firstRow; y < lastRow; y++) {
+        Uint32* row = target.pixels + (size_t) y * target.stride;
+        double cellY = originY + (y + 0.5) * cellsPerPixel;
+        if (cellY < 0 || cellY >= numCellY || lastBlock < firstBlock) {
+            std::fill(row, row + target.width, backgroundValue);
+            continue;
+        }
+        int blockY = std::min((int) cellY >> level, blocksY - 1);
+        if (blockY != colorRow) {
+            colorRow = blockY;
+            for (int blockX = firstBlock; blockX <= lastBlock; blockX++) {
+                blockColor[blockX - firstBlock] = overviewColor(level, blockX, blockY);
+                const LodBlock& block = lod.block(level, blockX, blockY);
+                if (block.visited > 0) {
+                    Uint32 mean = (Uint32) (block.distanceSum / block.visited);
+                    minDistance = std::min(minDistance, mean);
+                    maxDistance = std::max(maxDistance, mean);
+                }
+            }
+        }
+        for (int x = 0; x < target.width; x++) {
+            int blockX = columns.blocks[x];
+            row[x] = blockX < 0 ? backgroundValue : blockColor[blockX - firstBlock];
         }
-        SDL_UnlockTexture(mazeTexture);
-        SDL_RenderCopyEx(game->app.renderer, mazeTexture, nullptr, nullptr, angle, nullptr, SDL_FLIP_NONE);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @name drawOverviewBand
+ * @brief One row band of displayOverview, drawn with the shared column map and the band's own slice of
+ * overviewColors
+ * @param band - index of this band
+ * @param bandCount - number of bands the frame is split into
+ * @memberof MazeComplex
+ */
+void MazeComplex::drawOverviewBand(int band, int bandCount){
+    int screenWidth = game->app.screenWidth;
+    int screenHeight = game->app.screenHeight;
+    Uint32 minDistance = UINT32_MAX, maxDistance = 0;
+    drawOverview(framebufferTarget(), view, overviewLevel, overviewColumns,
+        &overviewColors[(size_t) band * (screenWidth + 1)], screenHeight * band / bandCount,
+        screenHeight * (band + 1) / bandCount, minDistance, maxDistance);
+}
+
+/**
+ * @name displayOverview
+ * @brief Pixel and cell mode once cells are smaller than a pixel. Drawing cell by cell would cost
+ * O(cells) and alias, so every screen pixel is drawn from the LOD pyramid level matching the zoom into
+ * the framebuffer, in parallel row bands, and uploaded whole. Walls are part of the block colors.
+ * Nothing is cached, so generation and the color wave need no damage tracking here; the dirty list
+ * is dropped and the next cell-level frame repaints from scratch.
+ * @param currentTime
+ * @memberof MazeComplex
+ */
+void MazeComplex::displayOverview(Uint32 currentTime){
+    int screenWidth = game->app.screenWidth;
+    int screenHeight = game->app.screenHeight;
+    float angle = game->renderConfig.angle;
+
+    advanceColorLut(currentTime);
+    clearDirty();
+    fullRedraw = true;
+
+    int bands = rasterPool->getThreadCount() * 4;
+    // Scratch only changes size with the screen, a steady frame allocates nothing
+    overviewBlocks.resize(screenWidth);
+    overviewColors.resize((size_t) bands * (screenWidth + 1));
+    overviewColumns = mapOverviewColumns(view, overviewLevel, screenWidth, overviewBlocks.data());
+    rasterPool->parallelFor(bands, [this, bands](int band) { drawOverviewBand(band, bands); });
+    game->frameTimer.end(PHASE_RASTER);
+
+    game->frameTimer.begin(PHASE_UPLOAD);
+    wholeScreen.assign(1, {0, 0, screenWidth, screenHeight});
+    SDL_Texture* screenTexture = screenRing.upload(framebuffer.data(), screenWidth, screenHeight, wholeScreen,
+        game->renderConfig.uploadMethod);
+    game->frameTimer.end(PHASE_UPLOAD);
+
+    // Every pixel is opaque, so cell mode's blended overlay textures draw the same
+    if (screenTexture) {
+        SDL_RenderCopyEx(game->app.renderer, screenTexture, nullptr, nullptr, angle, nullptr, SDL_FLIP_NONE);
+    }
+}
@@ -0,0 +1,174 @@
+#include <occupancy_grid.hpp>
+#include <cstring>
+
+/**
+ * @name reset
+ * @brief Resizes the grid and marks every cell as free. The summed-area table carries an extra
+ * row and column of zeros so lookups never need to special case the edges.
+ * @param width - Integer, number of cells in x
+ * @param height - Integer, number of cells in y
+ * @memberof OccupancyGrid
+ */
+void OccupancyGrid::reset(int width, int height){
+    gridWidth = width;
+    gridHeight = height;
+    occupied.assign(width * height, 0);
+    summedArea.assign((width + 1) * (height + 1), 0);
+    pending.clear();
+    // Balance an O(width * height) rebuild against scanning the pending list on every query
+    maxPending = std::max<size_t>(64, (size_t) std::sqrt((double) width * height) / 4);
+}
+
+/**
+ * @name rebuildSummedArea
+ * @brief Recomputes the summed-area table from the bitmap in one O(width * height) pass and
+ * empties the pending list.
+ * @memberof OccupancyGrid
+ */
+void OccupancyGrid::rebuildSummedArea() const {
+    int stride = gridWidth + 1;
+    for (int y = 0; y < gridHeight; y++){
+        const Uint8* row = &occupied[y * gridWidth];
+        const int* above = &summedArea[y * stride];
+        int* sums = &summedArea[(y + 1) * stride];
+        int rowSum = 0;
+        for (int x = 0; x < gridWidth; x++){
+            rowSum += row[x];
+            sums[x + 1] = above[x + 1] + rowSum;
+        }
+    }
+    pending.clear();
+}
+
+/**
+ * @name anyOccupied
+ * @brief True if any cell in [x0, x1) x [y0, y1) is claimed. Four lookups into the summed-area
+ * table plus an overlap test against the pending claims. Once more than a few claims are pending,
+ * small rectangles (room probes between placements) read the bitmap row by row instead: it is always
+ * current, so they neither scan the pending list nor force a rebuild. Caller clips the rectangle to
+ * the grid.
+ * @memberof OccupancyGrid
+ */
+bool OccupancyGrid::anyOccupied(int x0, int y0, int x1, int y1) const {
+    if (pending.size() > shortPending && (x1 - x0) * (y1 - y0) <= directScanCells) {
+        for (int y = y0; y < y1; y++){
+            if (std::memchr(&occupied[y * gridWidth + x0], 1, x1 - x0)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (pending.size() > maxPending) {
+        rebuildSummedArea();
+    }
+    int stride = gridWidth + 1;
+    int count = summedArea[y1 * stride + x1]
+              - summedArea[y0 * stride + x1]
+              - summedArea[y1 * stride + x0]
+              + summedArea[y0 * stride + x0];
+    if (count != 0) {
+        return true;
+    }
+    for (const PendingRect& rect : pending){
+        if (rect.x0 < x1 && x0 < rect.x1 && rect.y0 < y1 && y0 < rect.y1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @name isFree
+ * @brief O(1) check that a w x h rectangle at (x, y) is inside the grid and has no occupied cells
+ * within margin cells of it (the margin is clipped to the grid).
+ * @return boolean - true if the rectangle can be claimed
+ * @memberof OccupancyGrid
+ */
+bool OccupancyGrid::isFree(int x, int y, int w, int h, int margin) const {
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > gridWidth || y + h > gridHeight) {
+        return false;
+    }
+    return !anyOccupied(std::max(x - margin, 0), std::max(y - margin, 0),
+        std::min(x + w + margin, gridWidth), std::min(y + h + margin, gridHeight));
+}
+
+/**
+ * @name isOccupied
+ * @return boolean - true if the single cell at (x, y) has been claimed
+ * @memberof OccupancyGrid
+ */
+bool OccupancyGrid::isOccupied(int x, int y) const {
+    return occupied[y * gridWidth + x] != 0;
+}
+
+/**
+ * @name occupy
+ * @brief Claims a free rectangle. The bitmap is written right away, the summed-area table catches
+ * up on a later query once enough claims have piled up, so placing thousands of rooms costs a
+ * handful of rebuilds rather than one per room.
+ * @param x, y - top left cell
+ * @param w, h - size in cells, the rectangle must be free (see isFree)
+ * @memberof OccupancyGrid
+ */
+void OccupancyGrid::occupy(int x, int y, int w, int h){
+    for (int row = y; row < y + h; row++){
+        std::fill_n(occupied.begin() + row * gridWidth + x, w, 1);
+    }
+    pending.push_back({x, y, x + w, y + h});
+}
+
+/**
+ * @name findFreePositions
+ * @brief Enumerates every top left cell where a w x h rectangle fits, in row-major order so the
+ * result is deterministic. Flushes pending claims first, then each candidate costs four lookups.
+ * @param w, h - size in cells
+ * @param positions - cleared and filled with cell indices (y * width + x)
+ * @param margin - free cells required around the rectangle
+ * @return int - number of valid positions
+ * @memberof OccupancyGrid
+ */
+int OccupancyGrid::findFreePositions(int w, int h, std::vector<int> &positions, int margin){
+    positions.clear();
+    if (w <= 0 || h <= 0 || w > gridWidth || h > gridHeight) {
+        return 0;
+    }
+    if (!pending.empty()) {
+        rebuildSummedArea();
+    }
+    for (int y = 0; y + h <= gridHeight; y++){
+        for (int x = 0; x + w <= gridWidth; x++){
+            if (isFree(x, y, w, h, margin)) {
+                positions.push_back(y * gridWidth + x);
+            }
+        }
+    }
+    return (int) positions.size();
+}
+
+/**
+ * @name findFreePositions
+ * @brief Like the full scan, but only tries the given positions, for narrowing down a list that is
+ * known to hold every valid one. Keeps their order.
+ * @param w, h - size in cells
+ * @param from - cell indices to try
+ * @param positions - cleared and filled with the ones where the rectangle fits
+ * @param margin - free cells required around the rectangle
+ * @return int - number of valid positions
+ * @memberof OccupancyGrid
+ */
+int OccupancyGrid::findFreePositions(int w, int h, const std::vector<int>& from, std::vector<int>& positions,
+    int margin){
+    positions.clear();
+    // A few pending claims are cheap to check, and a short list is cheaper to check against the bitmap
+    // than to rebuild the table for
+    size_t area = (size_t) (w + 2 * margin) * (h + 2 * margin);
+    if (pending.size() > shortPending && from.size() * area > (size_t) gridWidth * gridHeight) {
+        rebuildSummedArea();
+    }
+    for (int position : from){
+        if (isFree(position % gridWidth, position / gridWidth, w, h, margin)) {
+            positions.push_back(position);
+        }
+    }
+    return (int) positions.size();
+}
@@ -0,0 +1,66 @@
+#include <pixel_format.hpp>
+
+/**
+ * @name packColor
+ * @brief Packs a color in a layout picked at runtime, for the handful of colors packed per frame
+ * (palette, background, walls). Every pixel after that is a copy of one of them.
+ * @param layout - PixelLayout
+ * @param color
+ * @return Uint32 - packed pixel
+ */
+Uint32 packColor(PixelLayout layout, const SDL_Color& color){
+    switch (layout) {
+        case LAYOUT_ABGR:
+            return packColor<LAYOUT_ABGR>(color.r, color.g, color.b, color.a);
+        case LAYOUT_RGBA:
+            return packColor<LAYOUT_RGBA>(color.r, color.g, color.b, color.a);
+        case LAYOUT_BGRA:
+            return packColor<LAYOUT_BGRA>(color.r, color.g, color.b, color.a);
+        default:
+            return packColor<LAYOUT_ARGB>(color.r, color.g, color.b, color.a);
+    }
+}
+
+/**
+ * @name pixelFormatFor
+ * @brief The SDL_PIXELFORMAT_* for textures holding pixels of a layout
+ * @param layout - PixelLayout
+ * @return Uint32
+ */
+Uint32 pixelFormatFor(PixelLayout layout){
+    switch (layout) {
+        case LAYOUT_ABGR:
+            return SDL_PIXELFORMAT_ABGR8888;
+        case LAYOUT_RGBA:
+            return SDL_PIXELFORMAT_RGBA8888;
+        case LAYOUT_BGRA:
+            return SDL_PIXELFORMAT_BGRA8888;
+        default:
+            return SDL_PIXELFORMAT_ARGB8888;
+    }
+}
+
+/**
+ * @name negotiatePixelLayout
+ * @brief Picks the layout to rasterize in from the texture formats the renderer supports, which SDL lists
+ * with the renderer's native ones first. Uploading a format the backend doesn't store natively makes the
+ * driver (or SDL, on the software renderer) convert every uploaded pixel; GLES backends prefer ABGR.
+ * Falls back to ARGB8888, which every SDL renderer accepts.
+ * @param renderer
+ * @return PixelLayout
+ */
+PixelLayout negotiatePixelLayout(SDL_Renderer* renderer){
+    SDL_RendererInfo info{};
+    if (!renderer || SDL_GetRendererInfo(renderer, &info) != 0) {
+        return LAYOUT_ARGB;
+    }
+    const PixelLayout layouts[] = {LAYOUT_ARGB, LAYOUT_ABGR, LAYOUT_RGBA, LAYOUT_BGRA};
+    for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+        for (PixelLayout layout : layouts) {
+            if (info.texture_formats[i] == pixelFormatFor(layout)) {
+                return layout;
+            }
+        }
+    }
+    return LAYOUT_ARGB;
+}
@@ -0,0 +1,174 @@
+#include <raster.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(__EMSCRIPTEN__)
+#define MAZE_RASTER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @name fillRowScalar
+ * @brief Fallback row kernel, also used for spans too short to be worth a vector store
+ */
+void fillRowScalar(Uint32* row, int count, Uint32 color) {
+    for (int i = 0; i < count; i++) {
+        row[i] = color;
+    }
+}
+
+#ifdef MAZE_RASTER_X86
+/**
+ * @name fillRowSSE2
+ * @brief Four pixels per unaligned store, the tail is finished with scalar writes
+ */
+__attribute__((target("sse2")))
+void fillRowSSE2(Uint32* row, int count, Uint32 color) {
+    __m128i value = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm_storeu_si128((__m128i*) (row + i), value);
+        _mm_storeu_si128((__m128i*) (row + i + 4), value);
+        _mm_storeu_si128((__m128i*) (row + i + 8), value);
+        _mm_storeu_si128((__m128i*) (row + i + 12), value);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*) (row + i), value);
+    }
+    fillRowScalar(row + i, count - i, color);
+}
+
+/**
+ * @name fillRowAVX2
+ * @brief Eight pixels per unaligned store, the tail is finished with scalar writes
+ */
+__attribute__((target("avx2")))
+void fillRowAVX2(Uint32* row, int count, Uint32 color) {
+    __m256i value = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        _mm256_storeu_si256((__m256i*) (row + i), value);
+        _mm256_storeu_si256((__m256i*) (row + i + 8), value);
+        _mm256_storeu_si256((__m256i*) (row + i + 16), value);
+        _mm256_storeu_si256((__m256i*) (row + i + 24), value);
+    }
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*) (row + i), value);
+    }
+    fillRowScalar(row + i, count - i, color);
+}
+#endif
+
+typedef void (*FillRowKernel)(Uint32* row, int count, Uint32 color);
+
+struct RowKernel {
+    FillRowKernel fill;
+    const char* name;
+};
+
+RowKernel pickRowKernel() {
+#ifdef MAZE_RASTER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {fillRowAVX2, "AVX2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {fillRowSSE2, "SSE2"};
+    }
+#endif
+    return {fillRowScalar, "Scalar"};
+}
+
+const RowKernel rowKernel = pickRowKernel();
+
+// Below this the call and vector setup cost more than they save (cell fills at small pixel sizes)
+constexpr int minVectorSpan = 8;
+
+inline void fillRow(Uint32* row, int count, Uint32 color) {
+    if (count < minVectorSpan) {
+        fillRowScalar(row, count, color);
+    } else {
+        rowKernel.fill(row, count, color);
+    }
+}
+
+/**
+ * @name clipSpan
+ * @brief Clips [start, start + length) to [0, limit). Returns false if nothing is left.
+ */
+inline bool clipSpan(int& start, int& length, int limit) {
+    if (start < 0) {
+        length += start;
+        start = 0;
+    }
+    length = std::min(length, limit - start);
+    return length > 0;
+}
+
+}
+
+/**
+ * @name fillRect
+ * @brief Fills a rectangle, clipped against the target once rather than per pixel
+ * @param target - buffer to draw into
+ * @param x, y - top left corner, may be outside the target
+ * @param w, h - size in pixels
+ * @param color - packed pixel value
+ */
+void fillRect(const PixelTarget& target, int x, int y, int w, int h, Uint32 color) {
+    if (!clipSpan(x, w, target.width) || !clipSpan(y, h, target.height)) {
+        return;
+    }
+    Uint32* row = target.pixels + (size_t) y * target.stride + x;
+    if (w == target.stride) {
+        // Full rows are contiguous, fill them as one span
+        fillRow(row, w * h, color);
+        return;
+    }
+    for (int i = 0; i < h; i++, row += target.stride) {
+        fillRow(row, w, color);
+    }
+}
+
+/**
+ * @name fillHLine
+ * @brief One pixel tall line, used for the north and south walls
+ * @param target - buffer to draw into
+ * @param x, y - left end of the line
+ * @param w - length in pixels
+ * @param color - packed pixel value
+ */
+void fillHLine(const PixelTarget& target, int x, int y, int w, Uint32 color) {
+    if (y < 0 || y >= target.height || !clipSpan(x, w, target.width)) {
+        return;
+    }
+    fillRow(target.pixels + (size_t) y * target.stride + x, w, color);
+}
+
+/**
+ * @name fillVLine
+ * @brief One pixel wide line, used for the east and west walls. A vertical line can't be vectorized,
+ * so this is a strided loop without any per pixel checks.
+ * @param target - buffer to draw into
+ * @param x, y - top end of the line
+ * @param h - length in pixels
+ * @param color - packed pixel value
+ */
+void fillVLine(const PixelTarget& target, int x, int y, int h, Uint32 color) {
+    if (x < 0 || x >= target.width || !clipSpan(y, h, target.height)) {
+        return;
+    }
+    Uint32* pixel = target.pixels + (size_t) y * target.stride + x;
+    for (int i = 0; i < h; i++, pixel += target.stride) {
+        *pixel = color;
+    }
+}
+
+/**
+ * @name rasterKernelName
+ * @brief Name of the row kernel picked for this CPU, for the UI
+ * @return const char*
+ */
+const char* rasterKernelName() {
+    return rowKernel.name;
+}
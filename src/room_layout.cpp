@@ -0,0 +1,394 @@
+#include <room_layout.hpp>
+
+/**
+ * @name generate
+ * @brief Places config.numRooms rooms into the occupancy grid, largest first. Rooms that don't fit
+ * anywhere are skipped. The time spent is kept for the UI.
+ * @param config - RoomLayoutConfig, counts, size range, spacing and packing strategy
+ * @param occupancy - OccupancyGrid, already reset to the maze dimensions
+ * @param rooms - cleared and filled with the placed rooms
+ * @return int - number of rooms placed
+ * @memberof RoomLayout
+ */
+int RoomLayout::generate(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms){
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+    rooms.clear();
+    candidateSpacing = -1;
+    widestSpacing = -1;
+    freeSpacing = -1;
+    smallestWidth = std::max(config.minWidth, 1);
+    smallestHeight = std::max(config.minHeight, 1);
+    lastRequested = config.numRooms;
+    if (config.numRooms > 0) {
+        sampleSizes(config);
+        switch (config.packing) {
+            case PACK_SKYLINE:
+                packSkyline(config, occupancy, rooms);
+                break;
+            case PACK_GUILLOTINE:
+                packGuillotine(config, occupancy, rooms);
+                break;
+            case PACK_RANDOM:
+            default:
+                packRandom(config, occupancy, rooms);
+                break;
+        }
+    }
+    Uint64 elapsed = SDL_GetPerformanceCounter() - startCounter;
+    lastPlacementMs = (double) elapsed * 1000.0 / (double) SDL_GetPerformanceFrequency();
+    return (int) rooms.size();
+}
+
+/**
+ * @name sampleSizes
+ * @brief Draws a size for every room, then sorts largest area first. Placing big rooms before small
+ * ones is what keeps the packers dense. SIZE_SMALL_BIASED takes the smaller of two uniform draws
+ * per axis, so most rooms are small with the occasional large hall.
+ * @param config - RoomLayoutConfig
+ * @memberof RoomLayout
+ */
+void RoomLayout::sampleSizes(const RoomLayoutConfig& config){
+    sizes.clear();
+    int rangeX = std::max(config.maxWidth - config.minWidth, 0) + 1;
+    int rangeY = std::max(config.maxHeight - config.minHeight, 0) + 1;
+    for (int i = 0; i < config.numRooms; i++){
+        int width = config.minWidth;
+        int height = config.minHeight;
+        switch (config.distribution) {
+            case SIZE_UNIFORM:
+                width += std::rand() % rangeX;
+                height += std::rand() % rangeY;
+                break;
+            case SIZE_SMALL_BIASED:
+                width += std::min(std::rand() % rangeX, std::rand() % rangeX);
+                height += std::min(std::rand() % rangeY, std::rand() % rangeY);
+                break;
+            case SIZE_FIXED:
+            default:
+                break;
+        }
+        sizes.push_back({0, 0, width, height});
+    }
+    // Equal sizes end up next to each other, which lets placeRandom reuse its candidate list.
+    // Ties are identical sizes, so std::sort is as deterministic as a stable sort without its buffer.
+    std::sort(sizes.begin(), sizes.end(), [](const RoomRect& a, const RoomRect& b){
+        if (a.width * a.height != b.width * b.height) {
+            return a.width * a.height > b.width * b.height;
+        }
+        return a.width > b.width;
+    });
+}
+
+/**
+ * @name placeRandom
+ * @brief Places one room at a random free position. A handful of O(1) random probes handle the
+ * common case. If they all miss, every valid position is enumerated and one is picked, so the room
+ * always lands when there is space. The room is claimed in the occupancy grid.
+ * The grid only ever fills up, so the enumerated list stays a superset of the valid positions for
+ * that room size. Later rooms of the same size draw from it directly and drop entries that have
+ * gone stale, instead of scanning the grid again. For the same reason a size that found no position
+ * never will, and neither will any room at least as wide and as tall: widestFree keeps that bound per
+ * height and turns those sizes away before they search.
+ * @param occupancy - OccupancyGrid to search and update
+ * @param width, height - room size in cells
+ * @param spacing - free cells required between this room and any other
+ * @param room - filled with the placed room
+ * @return boolean - true if the room was placed
+ * @memberof RoomLayout
+ */
+bool RoomLayout::placeRandom(OccupancyGrid& occupancy, int width, int height, int spacing, RoomRect& room){
+    int gridWidth = occupancy.getWidth();
+    int gridHeight = occupancy.getHeight();
+    if (width <= 0 || height <= 0 || width > gridWidth || height > gridHeight) {
+        return false;
+    }
+    bool cached = candidateWidth == width && candidateHeight == height && candidateSpacing == spacing;
+    bool found = false;
+    if (!cached) {
+        int spanX = gridWidth - width + 1;
+        int spanY = gridHeight - height + 1;
+        int attempts = 20;
+        for (int i = 0; i < attempts && !found; i++){
+            room = {std::rand() % spanX, std::rand() % spanY, width, height};
+            found = occupancy.isFree(room.x, room.y, width, height, spacing);
+        }
+        if (!found) {
+            // Crowded grid. Sizes that can't fit anymore are ruled out without a scan
+            if (widestSpacing != spacing) {
+                widestFree.assign(gridHeight + 1, gridWidth);
+                widestSpacing = spacing;
+            }
+            if (widestFree[height] < width) {
+                return false;
+            }
+            FreeTier* tier;
+            std::vector<int>& index = freeIndex(occupancy, width, height, spacing, tier);
+            found = probeFreeIndex(occupancy, index, tier->width, tier->height, width, height, spacing, room);
+            if (!found) {
+                // Fall back to every position the room fits at. The index drops its stale positions
+                // first, it is only ever narrowed down, never scanned for again
+                occupancy.findFreePositions(tier->width, tier->height, index, candidates, spacing);
+                index.swap(candidates);
+                occupancy.findFreePositions(width, height, index, candidates, spacing);
+                candidateWidth = width;
+                candidateHeight = height;
+                candidateSpacing = spacing;
+                if (candidates.empty()) {
+                    // Nothing at least this wide and this tall fits from now on
+                    for (int h = height; h <= gridHeight; h++){
+                        widestFree[h] = std::min(widestFree[h], width - 1);
+                    }
+                }
+            }
+        }
+    }
+    while (!found && !candidates.empty()){
+        size_t pick = std::rand() % candidates.size();
+        int position = candidates[pick];
+        room = {position % gridWidth, position / gridWidth, width, height};
+        found = occupancy.isFree(room.x, room.y, width, height, spacing);
+        candidates[pick] = candidates.back();
+        candidates.pop_back();
+    }
+    if (!found) {
+        return false;
+    }
+    occupancy.occupy(room.x, room.y, width, height);
+    return true;
+}
+
+/**
+ * @name freeIndex
+ * @brief The free index for a room: positions where a tier sized room still fits, for the biggest tier
+ * no larger than the room either way. The room can only fit at one of those, and the bigger the tier,
+ * the fewer positions there are to look at. Tier sizes double from the smallest room's, separately in
+ * width and height so long thin rooms get a tight index too. The smallest tier is scanned for once,
+ * every other one is narrowed down from its neighbour below when first needed.
+ * Rooms only ever get added, so every index stays a superset of its valid positions.
+ * @param occupancy - OccupancyGrid to search
+ * @param width, height - room size in cells
+ * @param spacing - free cells required between this room and any other
+ * @param tier - out, the tier of the returned index
+ * @return std::vector<int>& - cell indices, in no particular order
+ * @memberof RoomLayout
+ */
+std::vector<int>& RoomLayout::freeIndex(OccupancyGrid& occupancy, int width, int height, int spacing,
+    FreeTier*& tier){
+    FreeTier& base = freeTiers[0];
+    if (freeSpacing != spacing || !base.built || width < base.width || height < base.height) {
+        for (FreeTier& other : freeTiers) {
+            other.built = false;
+        }
+        base.width = std::min(width, smallestWidth);
+        base.height = std::min(height, smallestHeight);
+        occupancy.findFreePositions(base.width, base.height, base.positions, spacing);
+        base.built = true;
+        freeSpacing = spacing;
+    }
+    int levelX = 0;
+    int levelY = 0;
+    while (levelX + 1 < tierLevels && base.width << (levelX + 1) <= width){
+        levelX++;
+    }
+    while (levelY + 1 < tierLevels && base.height << (levelY + 1) <= height){
+        levelY++;
+    }
+    // Walk up from the base, first in width then in height, building what's missing
+    FreeTier* below = &base;
+    for (int step = 1; step <= levelX + levelY; step++){
+        int x = std::min(step, levelX);
+        int y = step - x;
+        FreeTier& next = freeTiers[y * tierLevels + x];
+        if (!next.built) {
+            next.width = base.width << x;
+            next.height = base.height << y;
+            occupancy.findFreePositions(next.width, next.height, below->positions, next.positions, spacing);
+            next.built = true;
+        }
+        below = &next;
+    }
+    tier = below;
+    return below->positions;
+}
+
+/**
+ * @name probeFreeIndex
+ * @brief Random probes into a free index. On a crowded grid these hit far more often than probes
+ * anywhere. Positions where the index's tier no longer fits are dropped for good, so the index
+ * shrinks as the grid fills.
+ * @param occupancy - OccupancyGrid to search
+ * @param index - from freeIndex
+ * @param tierWidth, tierHeight - room size the index is for
+ * @param width, height - room size in cells
+ * @param spacing - free cells required between this room and any other
+ * @param room - filled with the position found
+ * @return boolean - true if a free position was found
+ * @memberof RoomLayout
+ */
+bool RoomLayout::probeFreeIndex(OccupancyGrid& occupancy, std::vector<int>& index, int tierWidth, int tierHeight,
+    int width, int height, int spacing, RoomRect& room){
+    int gridWidth = occupancy.getWidth();
+    int attempts = 64;
+    for (int i = 0; i < attempts && !index.empty(); i++){
+        size_t pick = std::rand() % index.size();
+        int position = index[pick];
+        room = {position % gridWidth, position / gridWidth, width, height};
+        if (occupancy.isFree(room.x, room.y, width, height, spacing)) {
+            return true;
+        }
+        if (!occupancy.isFree(room.x, room.y, tierWidth, tierHeight, spacing)) {
+            index[pick] = index.back();
+            index.pop_back();
+        }
+    }
+    return false;
+}
+
+/**
+ * @name packRandom
+ * @brief Scatters rooms with placeRandom, the closest match to how rooms were placed before packing.
+ * @memberof RoomLayout
+ */
+void RoomLayout::packRandom(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms){
+    RoomRect room{};
+    for (const RoomRect& size : sizes){
+        if (placeRandom(occupancy, size.width, size.height, config.spacing, room)) {
+            rooms.push_back(room);
+        }
+    }
+}
+
+/**
+ * @name packSkyline
+ * @brief Skyline bottom-left packing. The skyline is a list of horizontal segments marking how far
+ * down each column range is filled. Each room goes where its top edge is lowest (smallest y), then
+ * leftmost. Rooms are padded by spacing on the right and bottom, and the packing area is grown by the
+ * same amount, so rooms keep their gap without wasting the grid's last row and column.
+ * @memberof RoomLayout
+ */
+void RoomLayout::packSkyline(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms){
+    int spacing = std::max(config.spacing, 0);
+    int areaWidth = occupancy.getWidth() + spacing;
+    int areaHeight = occupancy.getHeight() + spacing;
+    skyline.clear();
+    skyline.push_back({0, 0, areaWidth});
+
+    for (const RoomRect& size : sizes){
+        int paddedWidth = size.width + spacing;
+        int paddedHeight = size.height + spacing;
+        int bestIndex = -1;
+        int bestX = 0;
+        int bestY = areaHeight;
+
+        for (size_t i = 0; i < skyline.size(); i++){
+            int x = skyline[i].x;
+            if (x + paddedWidth > areaWidth) {
+                break;
+            }
+            // Resting height is the tallest segment under the room's span
+            int y = 0;
+            int widthLeft = paddedWidth;
+            for (size_t j = i; widthLeft > 0; j++){
+                y = std::max(y, skyline[j].y);
+                widthLeft -= skyline[j].width;
+            }
+            if (y + paddedHeight <= areaHeight && y < bestY) {
+                bestIndex = (int) i;
+                bestX = x;
+                bestY = y;
+            }
+        }
+        if (bestIndex < 0) {
+            continue;
+        }
+        occupancy.occupy(bestX, bestY, size.width, size.height);
+        rooms.push_back({bestX, bestY, size.width, size.height});
+
+        // Raise the skyline under the room, trimming the segments it now covers
+        skyline.insert(skyline.begin() + bestIndex, {bestX, bestY + paddedHeight, paddedWidth});
+        int right = bestX + paddedWidth;
+        size_t next = bestIndex + 1;
+        while (next < skyline.size() && skyline[next].x < right){
+            int overlap = right - skyline[next].x;
+            if (skyline[next].width <= overlap) {
+                skyline.erase(skyline.begin() + next);
+            } else {
+                skyline[next].x += overlap;
+                skyline[next].width -= overlap;
+                break;
+            }
+        }
+        // Merge neighbours at the same height so the list stays short
+        for (size_t i = 1; i < skyline.size();){
+            if (skyline[i - 1].y == skyline[i].y) {
+                skyline[i - 1].width += skyline[i].width;
+                skyline.erase(skyline.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+}
+
+/**
+ * @name packGuillotine
+ * @brief Guillotine packing. Keeps a list of free rectangles, starting with the whole (padded) grid.
+ * Each room takes the free rectangle it fits most snugly (best short side fit), and the leftover
+ * L-shape is cut along the shorter axis into two new free rectangles. Slivers smaller than the
+ * smallest room can never be used, so they are dropped right away to keep the list short.
+ * @memberof RoomLayout
+ */
+void RoomLayout::packGuillotine(const RoomLayoutConfig& config, OccupancyGrid& occupancy, std::vector<RoomRect>& rooms){
+    int spacing = std::max(config.spacing, 0);
+    int minPaddedWidth = config.minWidth + spacing;
+    int minPaddedHeight = config.minHeight + spacing;
+    freeRects.clear();
+    freeRects.push_back({0, 0, occupancy.getWidth() + spacing, occupancy.getHeight() + spacing});
+
+    for (const RoomRect& size : sizes){
+        int paddedWidth = size.width + spacing;
+        int paddedHeight = size.height + spacing;
+        int bestIndex = -1;
+        int bestShortSide = INT32_MAX;
+        int bestArea = INT32_MAX;
+        for (size_t i = 0; i < freeRects.size(); i++){
+            const RoomRect& free = freeRects[i];
+            if (free.width < paddedWidth || free.height < paddedHeight) {
+                continue;
+            }
+            int shortSide = std::min(free.width - paddedWidth, free.height - paddedHeight);
+            int area = free.width * free.height;
+            if (shortSide < bestShortSide || (shortSide == bestShortSide && area < bestArea)) {
+                bestIndex = (int) i;
+                bestShortSide = shortSide;
+                bestArea = area;
+            }
+        }
+        if (bestIndex < 0) {
+            continue;
+        }
+        RoomRect free = freeRects[bestIndex];
+        freeRects[bestIndex] = freeRects.back();
+        freeRects.pop_back();
+        occupancy.occupy(free.x, free.y, size.width, size.height);
+        rooms.push_back({free.x, free.y, size.width, size.height});
+
+        int leftoverX = free.width - paddedWidth;
+        int leftoverY = free.height - paddedHeight;
+        RoomRect right{};
+        RoomRect bottom{};
+        if (leftoverX < leftoverY) {
+            right = {free.x + paddedWidth, free.y, leftoverX, paddedHeight};
+            bottom = {free.x, free.y + paddedHeight, free.width, leftoverY};
+        } else {
+            right = {free.x + paddedWidth, free.y, leftoverX, free.height};
+            bottom = {free.x, free.y + paddedHeight, paddedWidth, leftoverY};
+        }
+        if (right.width >= minPaddedWidth && right.height >= minPaddedHeight) {
+            freeRects.push_back(right);
+        }
+        if (bottom.width >= minPaddedWidth && bottom.height >= minPaddedHeight) {
+            freeRects.push_back(bottom);
+        }
+    }
+}
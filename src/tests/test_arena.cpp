@@ -0,0 +1,129 @@
+#include <test_arena.h>
+#include <game.hpp>
+#include <cassert>
+#include <atomic>
+#include <new>
+
+// Every global operator new in maze_tests, to catch heap allocations that don't go through the arena.
+// Only linked into the test executable, the app keeps the standard allocator
+static std::atomic<long> globalAllocations{0};
+
+void* operator new(size_t bytes) {
+    globalAllocations++;
+    while (true) {
+        if (void* pointer = std::malloc(bytes ? bytes : 1)) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    allocations++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void CountingResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    deallocations++;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void ArenaTester::test_reset_reuses_capacity() {
+    CountingResource counter;
+    MazeArena arena(&counter);
+    for (int cycle = 0; cycle < 2; cycle++) {
+        arena.allocate<MazeElement>(6400);
+        arena.allocate<Uint32>(6400);
+        arena.allocate<Uint8>(6400);
+        arena.reset();
+    }
+    int warmed = counter.allocations;
+    for (int cycle = 0; cycle < 10; cycle++) {
+        ArenaArray<Uint32> distances = arena.allocate<Uint32>(6400);
+        distances[6399] = 1;
+        arena.allocate<MazeElement>(6400);
+        arena.allocate<Uint8>(6400);
+        arena.reset();
+    }
+    assert(counter.allocations == warmed);
+    // A bigger maze spills once, then the next reset sizes the block for it
+    arena.allocate<Uint32>(100000);
+    arena.reset();
+    warmed = counter.allocations;
+    arena.allocate<Uint32>(100000);
+    arena.reset();
+    assert(counter.allocations == warmed);
+}
+
+void ArenaTester::test_steady_state_generation() {
+    CountingResource counter;
+    Application app{};
+    Game game(app);
+    game.renderConfig = {false, 12, 3, 3, 10};
+    ColorConfig colors{};
+    MazeComplex maze(&game, &colors, &counter);
+    maze.configureRooms(game.renderConfig.roomLayout());
+    for (int cycle = 0; cycle < 3; cycle++) {
+        maze.generateCompleteMaze();
+        maze.resetMazeComplex();
+        maze.initMazeComplex();
+    }
+    for (int cycle = 0; cycle < 3; cycle++) {
+        maze.generateCompleteMaze();
+        maze.displayMazeComplex(cycle);
+        maze.resetMazeComplex();
+        maze.initMazeComplex();
+    }
+    int warmed = counter.allocations;
+    long warmedGlobal = globalAllocations;
+    for (int cycle = 0; cycle < 20; cycle++) {
+        maze.generateCompleteMaze();
+        maze.displayMazeComplex(cycle);
+        maze.resetMazeComplex();
+        maze.initMazeComplex();
+    }
+    assert(counter.allocations == warmed);
+    assert(globalAllocations == warmedGlobal);
+}
+
+void ArenaTester::test_steady_state_overview() {
+    Application app{};
+    Game game(app);
+    game.renderConfig = {false, 0, 3, 3, 10};
+    game.renderConfig.gridWidth = 1024;
+    game.renderConfig.gridHeight = 1024;
+    ColorConfig colors{};
+    MazeComplex maze(&game, &colors);
+    maze.generateCompleteMaze();
+    // Zoomed out far enough that every frame is drawn from the LOD pyramid
+    game.camera.fit(maze.getWorldWidth(), maze.getWorldHeight(), game.app.screenWidth, game.app.screenHeight);
+    for (RenderMode mode : {RENDER_PIXEL, RENDER_CELL}) {
+        game.renderConfig.renderMode = mode;
+        maze.updateRasterConfig();
+        for (int frame = 0; frame < 3; frame++) {
+            maze.displayMazeComplex(frame * 16);
+        }
+        assert(maze.getOverviewLevel() > 0);
+        long warmedGlobal = globalAllocations;
+        for (int frame = 3; frame < 20; frame++) {
+            maze.displayMazeComplex(frame * 16);
+        }
+        assert(globalAllocations == warmedGlobal);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MAZE_TEST_ARENA_H
+#define MAZE_TEST_ARENA_H
+#include <common.hpp>
+#include <maze_arena.hpp>
+
+/**
+ * Counts requests that reach the heap, used to check the arena stops allocating once warmed up
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    int allocations = 0;
+    int deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+class ArenaTester {
+public:
+    static void test_reset_reuses_capacity();
+    static void test_steady_state_generation();
+    static void test_steady_state_overview();
+};
+
+
+#endif //MAZE_TEST_ARENA_H
@@ -24,3 +24,22 @@ void Tester::test_hash_function() {
     assert(config.hash() != config3.hash());
 }
 
+void Tester::test_config_classification() {
+    MazeRenderConfig config = {
+        true,
+        2,
+        5,
+        5
+    };
+    MazeRenderConfig rotated = config;
+    rotated.angle = 45.0f;
+    assert(rotated.classify(config) == VIEW_CHANGE);
+    MazeRenderConfig resized = rotated;
+    resized.pixelSize = 20;
+    assert(resized.classify(config) == RASTER_CHANGE);
+    MazeRenderConfig reseeded = resized;
+    reseeded.seed = 42;
+    assert(reseeded.classify(config) == TOPOLOGY_CHANGE);
+    assert(config.classify(config) == NO_CHANGE);
+    assert(config == config);
+}
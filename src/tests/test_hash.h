@@ -5,6 +5,7 @@
 class Tester {
 public:
     static void test_hash_function();
+    static void test_config_classification();
 };
 
 
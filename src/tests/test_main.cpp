@@ -0,0 +1,24 @@
+#include <test_hash.h>
+#include <test_occupancy.h>
+#include <test_arena.h>
+#include <test_room_layout.h>
+#include <cstdio>
+
+/**
+ * @brief Runs every test, built as maze_tests and registered with ctest. Checks are asserts, the first
+ * failure aborts the run.
+ * @return 0 when all tests passed
+ */
+int main(int argc, char** argv){
+    Tester::test_hash_function();
+    Tester::test_config_classification();
+    OccupancyTester::test_free_rectangles();
+    OccupancyTester::test_fills_remaining_space();
+    RoomLayoutTester::test_every_packing_keeps_rooms_apart();
+    RoomLayoutTester::test_random_fills_remaining_space();
+    ArenaTester::test_reset_reuses_capacity();
+    ArenaTester::test_steady_state_generation();
+    ArenaTester::test_steady_state_overview();
+    printf("All tests passed\n");
+    return 0;
+}
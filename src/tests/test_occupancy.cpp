@@ -0,0 +1,30 @@
+#include <test_occupancy.h>
+#include <cassert>
+
+void OccupancyTester::test_free_rectangles() {
+    OccupancyGrid grid;
+    grid.reset(10, 8);
+    assert(grid.isFree(0, 0, 10, 8));
+    assert(!grid.isFree(5, 5, 6, 1));
+    grid.occupy(2, 3, 4, 2);
+    assert(grid.isOccupied(2, 3));
+    assert(grid.isOccupied(5, 4));
+    assert(!grid.isOccupied(6, 4));
+    assert(!grid.isFree(0, 0, 3, 4));
+    assert(grid.isFree(0, 0, 2, 8));
+    assert(grid.isFree(6, 0, 4, 8));
+    assert(grid.isFree(0, 5, 10, 3));
+}
+
+void OccupancyTester::test_fills_remaining_space() {
+    OccupancyGrid grid;
+    grid.reset(6, 6);
+    std::vector<int> positions;
+    // Four 3x3 rooms fit exactly, every placement must find one
+    for (int i = 0; i < 4; i++) {
+        int found = grid.findFreePositions(3, 3, positions);
+        assert(found > 0);
+        grid.occupy(positions[0] % 6, positions[0] / 6, 3, 3);
+    }
+    assert(grid.findFreePositions(1, 1, positions) == 0);
+}
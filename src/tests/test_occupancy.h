@@ -0,0 +1,13 @@
+#ifndef MAZE_TEST_OCCUPANCY_H
+#define MAZE_TEST_OCCUPANCY_H
+#include <common.hpp>
+#include <occupancy_grid.hpp>
+
+class OccupancyTester {
+public:
+    static void test_free_rectangles();
+    static void test_fills_remaining_space();
+};
+
+
+#endif //MAZE_TEST_OCCUPANCY_H
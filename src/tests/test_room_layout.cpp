@@ -0,0 +1,72 @@
+#include <test_room_layout.h>
+#include <cassert>
+
+// Rooms stay inside the grid, within the size range, claimed in the grid and spacing cells apart
+static void checkLayout(const RoomLayoutConfig& config, const OccupancyGrid& grid, int gridWidth, int gridHeight,
+    const std::vector<RoomRect>& rooms) {
+    for (size_t i = 0; i < rooms.size(); i++) {
+        const RoomRect& room = rooms[i];
+        assert(room.x >= 0 && room.y >= 0);
+        assert(room.x + room.width <= gridWidth && room.y + room.height <= gridHeight);
+        assert(room.width >= config.minWidth && room.width <= config.maxWidth);
+        assert(room.height >= config.minHeight && room.height <= config.maxHeight);
+        assert(grid.isOccupied(room.x, room.y));
+        assert(grid.isOccupied(room.x + room.width - 1, room.y + room.height - 1));
+        for (size_t j = i + 1; j < rooms.size(); j++) {
+            const RoomRect& other = rooms[j];
+            bool apart = room.x + room.width + config.spacing <= other.x ||
+                other.x + other.width + config.spacing <= room.x ||
+                room.y + room.height + config.spacing <= other.y ||
+                other.y + other.height + config.spacing <= room.y;
+            assert(apart);
+        }
+    }
+}
+
+void RoomLayoutTester::test_every_packing_keeps_rooms_apart() {
+    const int gridWidth = 120, gridHeight = 90;
+    RoomLayout layout;
+    std::vector<RoomRect> rooms;
+    for (RoomPacking packing : {PACK_RANDOM, PACK_SKYLINE, PACK_GUILLOTINE}) {
+        for (RoomSizeDistribution distribution : {SIZE_FIXED, SIZE_UNIFORM, SIZE_SMALL_BIASED}) {
+            for (int spacing : {0, 2}) {
+                RoomLayoutConfig config;
+                // More rooms than fit, so the packers run out of space and take their fallback paths
+                config.numRooms = 2500;
+                config.minWidth = 3;
+                config.minHeight = 2;
+                config.maxWidth = distribution == SIZE_FIXED ? 3 : 11;
+                config.maxHeight = distribution == SIZE_FIXED ? 2 : 7;
+                config.spacing = spacing;
+                config.packing = packing;
+                config.distribution = distribution;
+                std::srand(17);
+                OccupancyGrid grid;
+                grid.reset(gridWidth, gridHeight);
+                int placed = layout.generate(config, grid, rooms);
+                assert(placed == (int) rooms.size());
+                assert(placed > 0 && placed < config.numRooms);
+                checkLayout(config, grid, gridWidth, gridHeight, rooms);
+            }
+        }
+    }
+}
+
+void RoomLayoutTester::test_random_fills_remaining_space() {
+    // Random packing of one size stops only once no room of that size fits anywhere
+    RoomLayout layout;
+    std::vector<RoomRect> rooms;
+    std::vector<int> positions;
+    for (int spacing : {0, 1, 3}) {
+        RoomLayoutConfig config;
+        config.numRooms = 2000;
+        config.minWidth = config.maxWidth = 4;
+        config.minHeight = config.maxHeight = 3;
+        config.spacing = spacing;
+        std::srand(5);
+        OccupancyGrid grid;
+        grid.reset(97, 61);
+        layout.generate(config, grid, rooms);
+        assert(grid.findFreePositions(4, 3, positions, spacing) == 0);
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef MAZE_TEST_ROOM_LAYOUT_H
+#define MAZE_TEST_ROOM_LAYOUT_H
+#include <common.hpp>
+#include <room_layout.hpp>
+
+class RoomLayoutTester {
+public:
+    static void test_every_packing_keeps_rooms_apart();
+    static void test_random_fills_remaining_space();
+};
+
+
+#endif //MAZE_TEST_ROOM_LAYOUT_H
@@ -0,0 +1,111 @@
+#include <texture_pool.hpp>
+
+/**
+ * @name TexturePool Destructor
+ * @brief Destroys anything still alive. Call destroyAll before the renderer goes away, this is
+ * only a safety net.
+ * @memberof TexturePool
+ */
+TexturePool::~TexturePool(){
+    destroyAll();
+}
+
+/**
+ * @name acquire
+ * @brief Hands out a texture, reusing an idle one with matching parameters. Its pixels and blend/scale
+ * modes are whatever the previous user left, callers set what they rely on.
+ * @param renderer - renderer the texture belongs to
+ * @param format - SDL_PIXELFORMAT_*
+ * @param access - SDL_TEXTUREACCESS_*
+ * @param width, height - size in pixels
+ * @return SDL_Texture* - nullptr if creation failed
+ * @memberof TexturePool
+ */
+SDL_Texture* TexturePool::acquire(SDL_Renderer* renderer, Uint32 format, int access, int width, int height){
+    for (Entry& entry : entries) {
+        if (!entry.inUse && entry.renderer == renderer && entry.format == format && entry.access == access &&
+            entry.width == width && entry.height == height) {
+            entry.inUse = true;
+            return entry.texture;
+        }
+    }
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, access, width, height);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TexturePool: failed to create %dx%d texture: %s",
+            width, height, SDL_GetError());
+        return nullptr;
+    }
+    entries.push_back({texture, renderer, format, access, width, height, true});
+    bytes += entryBytes(entries.back());
+    return texture;
+}
+
+/**
+ * @name release
+ * @brief Marks a texture idle so a later acquire can reuse it. nullptr is ignored.
+ * @param texture - texture from acquire
+ * @memberof TexturePool
+ */
+void TexturePool::release(SDL_Texture* texture){
+    for (Entry& entry : entries) {
+        if (entry.texture == texture) {
+            entry.inUse = false;
+            return;
+        }
+    }
+}
+
+/**
+ * @name trim
+ * @brief Destroys every idle texture
+ * @memberof TexturePool
+ */
+void TexturePool::trim(){
+    auto stale = std::remove_if(entries.begin(), entries.end(), [this](const Entry& entry) {
+        if (entry.inUse) {
+            return false;
+        }
+        SDL_DestroyTexture(entry.texture);
+        bytes -= entryBytes(entry);
+        return true;
+    });
+    entries.erase(stale, entries.end());
+}
+
+/**
+ * @name destroyAll
+ * @brief Destroys every texture, in use or not. Used at shutdown, before the renderer is destroyed.
+ * @memberof TexturePool
+ */
+void TexturePool::destroyAll(){
+    for (const Entry& entry : entries) {
+        SDL_DestroyTexture(entry.texture);
+    }
+    entries.clear();
+    bytes = 0;
+}
+
+/**
+ * @name getIdleCount
+ * @brief Number of textures waiting to be reused or trimmed
+ * @return int
+ * @memberof TexturePool
+ */
+int TexturePool::getIdleCount() const{
+    int idle = 0;
+    for (const Entry& entry : entries) {
+        idle += entry.inUse ? 0 : 1;
+    }
+    return idle;
+}
+
+/**
+ * @name entryBytes
+ * @brief Memory of one texture, as width * height * bytes per pixel. Drivers may pad, so it's an estimate.
+ * @param entry
+ * @return size_t
+ * @memberof TexturePool
+ */
+size_t TexturePool::entryBytes(const Entry& entry){
+    return (size_t) entry.width * entry.height * SDL_BYTESPERPIXEL(entry.format);
+}
@@ -0,0 +1,184 @@
+#include <texture_ring.hpp>
+
+/**
+ * @name acquire
+ * @brief Gets slotCount streaming textures of the given format and size from the pool. The previous ones
+ * go back first, so asking for the same again gets the same textures back. New textures start out
+ * needing a full upload.
+ * @param pool
+ * @param renderer
+ * @param format - SDL_PIXELFORMAT_*, 32 bits per pixel
+ * @param width, height - texture size
+ * @param slotCount - 1 to maxSlots
+ * @memberof TextureRing
+ */
+void TextureRing::acquire(TexturePool& pool, SDL_Renderer* renderer, Uint32 format, int width, int height,
+    int slotCount){
+    release(pool);
+    this->slotCount = std::clamp(slotCount, 1, maxSlots);
+    this->width = width;
+    this->height = height;
+    for (int i = 0; i < this->slotCount; i++) {
+        slots[i].texture = pool.acquire(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+        slots[i].pending.clear();
+        slots[i].full = true;
+    }
+    current = 0;
+}
+
+/**
+ * @name release
+ * @brief Hands every texture back to the pool
+ * @param pool
+ * @memberof TextureRing
+ */
+void TextureRing::release(TexturePool& pool){
+    for (int i = 0; i < slotCount; i++) {
+        pool.release(slots[i].texture);
+        slots[i].texture = nullptr;
+    }
+    slotCount = 0;
+    width = 0;
+    height = 0;
+}
+
+/**
+ * @name setBlendMode
+ * @param mode
+ * @memberof TextureRing
+ */
+void TextureRing::setBlendMode(SDL_BlendMode mode){
+    for (int i = 0; i < slotCount; i++) {
+        SDL_SetTextureBlendMode(slots[i].texture, mode);
+    }
+}
+
+/**
+ * @name setScaleMode
+ * @param mode
+ * @memberof TextureRing
+ */
+void TextureRing::setScaleMode(SDL_ScaleMode mode){
+    for (int i = 0; i < slotCount; i++) {
+        SDL_SetTextureScaleMode(slots[i].texture, mode);
+    }
+}
+
+/**
+ * @name upload
+ * @brief Moves on to the next texture and brings it up to date: the rects it missed while the others
+ * were drawn, plus this frame's damage. The other textures remember this frame's damage for their turn.
+ * Nothing moves when there is no damage and the current texture is up to date, so a static frame keeps
+ * drawing the same texture.
+ * @param pixels - full CPU image, pixelsWidth per row
+ * @param pixelsWidth, pixelsHeight - size of the CPU image, at most the texture size
+ * @param damage - rects that changed this frame
+ * @param method - SDL_UpdateTexture or SDL_LockTexture
+ * @return SDL_Texture* - the texture to draw this frame
+ * @memberof TextureRing
+ */
+SDL_Texture* TextureRing::upload(const Uint32* pixels, int pixelsWidth, int pixelsHeight,
+    const std::vector<SDL_Rect>& damage, UploadMethod method){
+    if (slotCount == 0) {
+        return nullptr;
+    }
+    if (damage.empty() && !slots[current].full) {
+        return slots[current].texture;
+    }
+    current = (current + 1) % slotCount;
+    for (int i = 0; i < slotCount; i++) {
+        if (i == current || slots[i].full) {
+            continue;
+        }
+        std::vector<SDL_Rect>& pending = slots[i].pending;
+        pending.insert(pending.end(), damage.begin(), damage.end());
+        if (pending.size() > maxPending) {
+            SDL_Rect bounds = pending[0];
+            for (const SDL_Rect& rect : pending) {
+                int right = std::max(bounds.x + bounds.w, rect.x + rect.w);
+                int bottom = std::max(bounds.y + bounds.h, rect.y + rect.h);
+                bounds.x = std::min(bounds.x, rect.x);
+                bounds.y = std::min(bounds.y, rect.y);
+                bounds.w = right - bounds.x;
+                bounds.h = bottom - bounds.y;
+            }
+            pending.assign(1, bounds);
+        }
+    }
+
+    Slot& slot = slots[current];
+    SDL_Rect whole{0, 0, std::min(pixelsWidth, width), std::min(pixelsHeight, height)};
+    if (slot.full) {
+        uploadRect(slot.texture, whole, pixels, pixelsWidth, method);
+    } else {
+        for (const SDL_Rect& rect : slot.pending) {
+            // Rects from an older, bigger image can hang over the current one
+            SDL_Rect clipped;
+            if (SDL_IntersectRect(&rect, &whole, &clipped)) {
+                uploadRect(slot.texture, clipped, pixels, pixelsWidth, method);
+            }
+        }
+        for (const SDL_Rect& rect : damage) {
+            uploadRect(slot.texture, rect, pixels, pixelsWidth, method);
+        }
+    }
+    slot.pending.clear();
+    slot.full = false;
+    return slot.texture;
+}
+
+/**
+ * @name uploadRect
+ * @brief Copies one rect of a CPU image into a streaming texture
+ * @param texture
+ * @param rect - in both the image and the texture
+ * @param pixels - CPU image, pixelsWidth per row
+ * @param pixelsWidth
+ * @param method - SDL_UpdateTexture, or lock the rect and copy the rows in
+ * @memberof TextureRing
+ */
+void TextureRing::uploadRect(SDL_Texture* texture, const SDL_Rect& rect, const Uint32* pixels, int pixelsWidth,
+    UploadMethod method){
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+    const Uint32* source = &pixels[(size_t) rect.y * pixelsWidth + rect.x];
+    if (method == UPLOAD_UPDATE) {
+        SDL_UpdateTexture(texture, &rect, source, pixelsWidth * (int) sizeof(Uint32));
+        return;
+    }
+    void* locked;
+    int pitch;
+    if (SDL_LockTexture(texture, &rect, &locked, &pitch) != 0) {
+        return;
+    }
+    for (int y = 0; y < rect.h; y++) {
+        std::memcpy((Uint8*) locked + (size_t) y * pitch, source + (size_t) y * pixelsWidth,
+            (size_t) rect.w * sizeof(Uint32));
+    }
+    SDL_UnlockTexture(texture);
+}
+
+/**
+ * @name preferredUploadMethod
+ * @brief Picks the upload method for a renderer's backend. The OpenGL, GLES and Metal backends keep a
+ * separate CPU buffer for a locked texture and upload it again on unlock, so locking costs an extra
+ * copy there. Direct3D and the software renderer map the memory they upload from, locking copies the
+ * pixels straight into it. Unknown backends get SDL_UpdateTexture, which every backend implements
+ * without staging of its own. The Upload setting still overrides this.
+ * @param renderer
+ * @return UploadMethod
+ */
+UploadMethod preferredUploadMethod(SDL_Renderer* renderer){
+    SDL_RendererInfo info{};
+    if (!renderer || SDL_GetRendererInfo(renderer, &info) != 0 || !info.name) {
+        return UPLOAD_UPDATE;
+    }
+    const char* lockingBackends[] = {"direct3d", "direct3d11", "direct3d12", "software"};
+    for (const char* name : lockingBackends) {
+        if (SDL_strcmp(info.name, name) == 0) {
+            return UPLOAD_LOCK;
+        }
+    }
+    return UPLOAD_UPDATE;
+}
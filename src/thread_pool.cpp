@@ -0,0 +1,111 @@
+#include <thread_pool.hpp>
+
+/**
+ * @name ThreadPool Constructor
+ * @brief Starts the workers, they sleep until parallelFor has something for them
+ * @param workerCount - number of threads besides the caller
+ * @memberof ThreadPool
+ */
+ThreadPool::ThreadPool(int workerCount){
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @name ThreadPool Destructor
+ * @brief Wakes the workers up to exit and joins them
+ * @memberof ThreadPool
+ */
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @name defaultWorkerCount
+ * @brief One worker per hardware thread, minus the caller. None when threads aren't available.
+ * @return int
+ * @memberof ThreadPool
+ */
+int ThreadPool::defaultWorkerCount(){
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 0;
+#else
+    int hardware = (int) std::thread::hardware_concurrency();
+    return std::clamp(hardware - 1, 0, 15);
+#endif
+}
+
+/**
+ * @name parallelFor
+ * @brief Runs job(0) .. job(count - 1) across the pool and the calling thread, in no particular order.
+ * Jobs must not touch the same data. Blocks until all of them have finished.
+ * @param count - number of jobs
+ * @param job - called once per job index
+ * @memberof ThreadPool
+ */
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& job){
+    if (count <= 1 || workers.empty()) {
+        for (int i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        jobCount = count;
+        nextJob = 0;
+        activeWorkers = (int) workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return activeWorkers == 0; });
+    currentJob = nullptr;
+}
+
+/**
+ * @name workerLoop
+ * @brief Waits for a new batch, helps run it and reports back. Every worker checks in once per batch,
+ * even if the other threads already took all the jobs.
+ * @memberof ThreadPool
+ */
+void ThreadPool::workerLoop(){
+    Uint64 seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        runJobs();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--activeWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+/**
+ * @name runJobs
+ * @brief Takes job indices off the shared counter until there are none left
+ * @memberof ThreadPool
+ */
+void ThreadPool::runJobs(){
+    for (int i = nextJob.fetch_add(1); i < jobCount; i = nextJob.fetch_add(1)) {
+        (*currentJob)(i);
+    }
+}
@@ -0,0 +1,204 @@
+#include <tile_cache.hpp>
+
+/**
+ * @name setBudget
+ * @brief How much texture memory the tiles may use. Shrinking it evicts at the end of the frame.
+ * @param bytes
+ * @memberof TileCache
+ */
+void TileCache::setBudget(size_t bytes){
+    budget = bytes;
+}
+
+/**
+ * @name levelForZoom
+ * @brief The cache level for a camera zoom: the largest power of two not above it, so tiles are only
+ * ever scaled up (by less than 2x) and 1 pixel walls never get dropped by the nearest filter
+ * @param zoom
+ * @return int - level, tiles at level L are rasterized at zoom 2^L
+ * @memberof TileCache
+ */
+int TileCache::levelForZoom(double zoom){
+    return std::clamp((int) std::floor(std::log2(zoom)), minLevel, maxLevel);
+}
+
+/**
+ * @name beginFrame
+ * @brief Starts a new frame, tiles acquired from here on count as on screen and can't be evicted
+ * @memberof TileCache
+ */
+void TileCache::beginFrame(){
+    frame++;
+    frameHits = 0;
+    frameLookups = 0;
+}
+
+/**
+ * @name acquire
+ * @brief Looks a tile up and makes it the most recently used. A fresh tile is a hit. A missing one is
+ * created stale, taking over the texture of the least recently used tile when the cache is at its budget
+ * and that tile isn't on screen, or a new pooled texture otherwise. Stale tiles have to be rasterized
+ * by the caller, which then clears the flag.
+ * @param pool - where new tile textures come from
+ * @param renderer
+ * @param format - SDL_PIXELFORMAT_* the tiles are rasterized in
+ * @param key
+ * @return Tile* - nullptr if no texture could be created
+ * @memberof TileCache
+ */
+Tile* TileCache::acquire(TexturePool& pool, SDL_Renderer* renderer, Uint32 format, const TileKey& key){
+    frameLookups++;
+    auto found = index.find(key);
+    if (found != index.end()) {
+        tiles.splice(tiles.begin(), tiles, found->second);
+        Tile& tile = tiles.front();
+        tile.lastUsedFrame = frame;
+        frameHits += tile.stale ? 0 : 1;
+        return &tile;
+    }
+
+    SDL_Texture* texture;
+    if ((tiles.size() + 1) * tileBytes > budget && !tiles.empty() && tiles.back().lastUsedFrame != frame) {
+        Tile& oldest = tiles.back();
+        texture = oldest.texture;
+        index.erase(oldest.key);
+        levelTiles[oldest.key.level - minLevel]--;
+        tiles.pop_back();
+    } else {
+        texture = pool.acquire(renderer, format, SDL_TEXTUREACCESS_STREAMING, tileSize, tileSize);
+        if (!texture) {
+            return nullptr;
+        }
+        SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+    }
+    tiles.push_front({key, texture, true, 1, 0, frame});
+    index[key] = tiles.begin();
+    levelTiles[key.level - minLevel]++;
+    return &tiles.front();
+}
+
+/**
+ * @name invalidateCell
+ * @brief A cell changed, every cached tile it touches is stale. Only levels that have tiles are checked.
+ * @param cellX, cellY - cell position
+ * @param cellSize - pixels per cell at zoom 1
+ * @memberof TileCache
+ */
+void TileCache::invalidateCell(int cellX, int cellY, int cellSize){
+    for (int level = minLevel; level <= maxLevel; level++) {
+        if (levelTiles[level - minLevel] == 0) {
+            continue;
+        }
+        // In doubles, a wide grid at a high level overflows int pixel coordinates
+        double scale = std::ldexp((double) cellSize, level);
+        double left = std::floor(cellX * scale), top = std::floor(cellY * scale);
+        double right = std::max(left, std::floor((cellX + 1) * scale) - 1);
+        double bottom = std::max(top, std::floor((cellY + 1) * scale) - 1);
+        if (scale < 1.0) {
+            // Drawn from the LOD pyramid, the cell's block can spill up to 2 pixels into the next tile
+            left = std::max(0.0, left - 2);
+            top = std::max(0.0, top - 2);
+            right += 2;
+            bottom += 2;
+        }
+        int firstX = (int) (left / tileSize), lastX = (int) (right / tileSize);
+        int firstY = (int) (top / tileSize), lastY = (int) (bottom / tileSize);
+        for (int y = firstY; y <= lastY; y++) {
+            for (int x = firstX; x <= lastX; x++) {
+                auto found = index.find({level, x, y});
+                if (found != index.end()) {
+                    found->second->stale = true;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @name invalidateDistances
+ * @brief Marks the tiles whose distance range uses a LUT entry that changed since the last frame.
+ * A prefix count of the changed entries makes each tile an O(1) check.
+ * Entries new this frame belong to freshly carved cells, their tiles were invalidated by invalidateCell.
+ * @param lut - this frame's colors
+ * @param previous - last frame's colors
+ * @memberof TileCache
+ */
+void TileCache::invalidateDistances(const std::vector<Uint32>& lut, const std::vector<Uint32>& previous){
+    int compared = (int) std::min(lut.size(), previous.size());
+    changedBefore.resize(compared + 1);
+    changedBefore[0] = 0;
+    for (int d = 0; d < compared; d++) {
+        changedBefore[d + 1] = changedBefore[d] + (lut[d] != previous[d] ? 1 : 0);
+    }
+    if (changedBefore[compared] == 0) {
+        return;
+    }
+    for (Tile& tile : tiles) {
+        if (tile.stale || tile.minDistance > tile.maxDistance) {
+            continue;
+        }
+        int low = (int) std::min<Uint32>(tile.minDistance, compared);
+        int high = (int) std::min<Uint32>(tile.maxDistance + 1, compared);
+        if (changedBefore[high] != changedBefore[low]) {
+            tile.stale = true;
+        }
+    }
+}
+
+/**
+ * @name invalidateAll
+ * @brief New maze, cell size or mode, every tile needs rasterizing again. Textures are kept.
+ * @memberof TileCache
+ */
+void TileCache::invalidateAll(){
+    for (Tile& tile : tiles) {
+        tile.stale = true;
+    }
+}
+
+/**
+ * @name evict
+ * @brief Drops a tile and hands its texture back to the pool
+ * @param tile
+ * @param pool
+ * @memberof TileCache
+ */
+void TileCache::evict(std::list<Tile>::iterator tile, TexturePool& pool){
+    pool.release(tile->texture);
+    index.erase(tile->key);
+    levelTiles[tile->key.level - minLevel]--;
+    tiles.erase(tile);
+}
+
+/**
+ * @name releaseAll
+ * @brief Empties the cache, used when leaving the tiled mode
+ * @param pool
+ * @memberof TileCache
+ */
+void TileCache::releaseAll(TexturePool& pool){
+    while (!tiles.empty()) {
+        evict(std::prev(tiles.end()), pool);
+    }
+}
+
+/**
+ * @name endFrame
+ * @brief Evicts down to the budget (a lowered budget, or tiles a big screen needed) and folds this
+ * frame's lookups into the smoothed hit rate
+ * @param pool
+ * @memberof TileCache
+ */
+void TileCache::endFrame(TexturePool& pool){
+    bool evicted = false;
+    while (tiles.size() * tileBytes > budget && tiles.back().lastUsedFrame != frame) {
+        evict(std::prev(tiles.end()), pool);
+        evicted = true;
+    }
+    if (evicted) {
+        pool.trim();
+    }
+    if (frameLookups > 0) {
+        hitRate = hitRate * 0.9 + 0.1 * frameHits / frameLookups;
+    }
+}
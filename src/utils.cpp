@@ -1,28 +1,5 @@
 #include <utils.hpp>
-
-/**
- * @name calculateDistance
- * @brief Calculate the manhatten distance between two points
- * @param x1
- * @param y1
- * @param x2
- * @param y2
- * @return int - manhatten distance
- */
-int calculateDistance(int x1, int y1, int x2, int y2){
-    return abs(x1 - x2) + abs(y1 - y2);
-}
-
-/**
- * @brief Helper function that takes two MazeElements, calculates
- * manhatten distance between their grid positions.
- * @param elem1
- * @param elem2
- * @return int - manhatten distance
- */
-int calculateDistance(const MazeElement& elem1, const MazeElement& elem2){
-    return calculateDistance(elem1.gridX, elem1.gridY, elem2.gridX, elem2.gridY);
-}
+#include <cstdio>
 
 /**
  * @name ImVec4ToSDLColor
@@ -37,4 +14,37 @@ SDL_Color ImVec4ToSDLColor(const ImVec4& imColor){
     sdlColor.b = static_cast<Uint8>(imColor.z * 255.0f);
     sdlColor.a = static_cast<Uint8>(imColor.w * 255.0f);
     return sdlColor;
-}
\ No newline at end of file
+}
+/**
+ * @name mixColor
+ * @brief Blends two packed colors, the even and odd bytes are weighted in two multiplies. Works on every
+ * PixelLayout since it never looks at which byte is which channel; two opaque colors mix to an opaque one.
+ * @param from - color at weight 0
+ * @param to - color at weight 256
+ * @param weight - 0 to 256
+ * @return Uint32 - packed in the same layout
+ */
+Uint32 mixColor(Uint32 from, Uint32 to, Uint32 weight){
+    Uint32 even = (((from & 0x00FF00FFu) * (256 - weight) + (to & 0x00FF00FFu) * weight) >> 8) & 0x00FF00FFu;
+    Uint32 odd = (((from >> 8) & 0x00FF00FFu) * (256 - weight) + ((to >> 8) & 0x00FF00FFu) * weight) & 0xFF00FF00u;
+    return even | odd;
+}
+
+/**
+ * @name numberedPath
+ * @brief maze.png becomes maze_0003.png, for writing image sequences
+ * @param path
+ * @param index
+ * @param digits - zero padded width of the number
+ * @return std::string
+ */
+std::string numberedPath(const std::string& path, int index, int digits){
+    char number[24];
+    snprintf(number, sizeof(number), "_%0*d", digits, index);
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + number;
+    }
+    return path.substr(0, dot) + number + path.substr(dot);
+}
@@ -0,0 +1,237 @@
+#include <wall_geometry.hpp>
+
+/**
+ * @name reset
+ * @brief Drops every quad and marks every row and column of the viewport for rebuilding
+ * @param view - visible cells and where their edges land on screen
+ * @param stride - cells per grid row
+ * @param color - wall color
+ * @memberof WallGeometry
+ */
+void WallGeometry::reset(const CellViewport& view, int stride, SDL_Color color){
+    this->view = view;
+    this->stride = stride;
+    this->color = color;
+    slotCount = 0;
+    basePositions.clear();
+    vertices.clear();
+    indices.clear();
+    freeSlots.clear();
+    int rows = view.height(), columns = view.width();
+    rowSlots.assign(rows, {});
+    columnSlots.assign(columns, {});
+    rowDirty.assign(rows, 1);
+    columnDirty.assign(columns, 1);
+    dirtyRows.resize(rows);
+    dirtyColumns.resize(columns);
+    for (int y = 0; y < rows; y++) {
+        dirtyRows[y] = view.y0 + y;
+    }
+    for (int x = 0; x < columns; x++) {
+        dirtyColumns[x] = view.x0 + x;
+    }
+}
+
+/**
+ * @name markCell
+ * @brief A cell's walls changed, its row and column get rebuilt by the next rebuild call.
+ * Cells outside the viewport have no quads and are ignored.
+ * @param x, y - cell position
+ * @memberof WallGeometry
+ */
+void WallGeometry::markCell(int x, int y){
+    if (!view.contains(x, y)) {
+        return;
+    }
+    if (!rowDirty[y - view.y0]) {
+        rowDirty[y - view.y0] = 1;
+        dirtyRows.push_back(y);
+    }
+    if (!columnDirty[x - view.x0]) {
+        columnDirty[x - view.x0] = 1;
+        dirtyColumns.push_back(x);
+    }
+}
+
+/**
+ * @name rebuild
+ * @brief Re-emits the quads of every marked row and column
+ * @param walls - per-cell wall masks (see directionBit) of the whole grid
+ * @memberof WallGeometry
+ */
+void WallGeometry::rebuild(const Uint8* walls){
+    for (int y : dirtyRows) {
+        rebuildRow(y, walls);
+        rowDirty[y - view.y0] = 0;
+    }
+    for (int x : dirtyColumns) {
+        rebuildColumn(x, walls);
+        columnDirty[x - view.x0] = 0;
+    }
+    dirtyRows.clear();
+    dirtyColumns.clear();
+}
+
+/**
+ * @name rebuildRow
+ * @brief North walls sit on the first pixel row of the cell, south walls on the last.
+ * Rows squashed to nothing by the zoom get no quads.
+ * @param y - cell row
+ * @param walls - per-cell wall masks
+ * @memberof WallGeometry
+ */
+void WallGeometry::rebuildRow(int y, const Uint8* walls){
+    std::vector<int>& owner = rowSlots[y - view.y0];
+    releaseSlots(owner);
+    int cellTop = view.edgeY(y), cellBottom = view.edgeY(y + 1);
+    if (cellBottom <= cellTop) {
+        return;
+    }
+    const Uint8* row = walls + (size_t) y * stride;
+    const Direction sides[2] = {NORTH, SOUTH};
+    for (Direction side : sides) {
+        Uint8 bit = directionBit(side);
+        float top = (float) (side == SOUTH ? cellBottom - 1 : cellTop);
+        for (int x = view.x0; x < view.x1; x++) {
+            if (!(row[x] & bit)) {
+                continue;
+            }
+            int start = x;
+            while (x + 1 < view.x1 && (row[x + 1] & bit)) {
+                x++;
+            }
+            int left = view.edgeX(start), right = view.edgeX(x + 1);
+            if (right > left) {
+                addQuad(owner, (float) left, top, (float) (right - left), 1.0f);
+            }
+        }
+    }
+}
+
+/**
+ * @name rebuildColumn
+ * @brief West walls sit on the first pixel column of the cell, east walls on the last
+ * @param x - cell column
+ * @param walls - per-cell wall masks
+ * @memberof WallGeometry
+ */
+void WallGeometry::rebuildColumn(int x, const Uint8* walls){
+    std::vector<int>& owner = columnSlots[x - view.x0];
+    releaseSlots(owner);
+    int cellLeft = view.edgeX(x), cellRight = view.edgeX(x + 1);
+    if (cellRight <= cellLeft) {
+        return;
+    }
+    const Direction sides[2] = {WEST, EAST};
+    for (Direction side : sides) {
+        Uint8 bit = directionBit(side);
+        float left = (float) (side == EAST ? cellRight - 1 : cellLeft);
+        for (int y = view.y0; y < view.y1; y++) {
+            if (!(walls[(size_t) y * stride + x] & bit)) {
+                continue;
+            }
+            int start = y;
+            while (y + 1 < view.y1 && (walls[(size_t) (y + 1) * stride + x] & bit)) {
+                y++;
+            }
+            int top = view.edgeY(start), bottom = view.edgeY(y + 1);
+            if (bottom > top) {
+                addQuad(owner, left, (float) top, 1.0f, (float) (bottom - top));
+            }
+        }
+    }
+}
+
+/**
+ * @name addQuad
+ * @brief Writes a quad into a free slot (or a new one at the end) and records it against its line
+ * @param owner - slot list of the row or column the quad belongs to
+ * @param x, y, w, h - unrotated rectangle in pixels
+ * @memberof WallGeometry
+ */
+void WallGeometry::addQuad(std::vector<int>& owner, float x, float y, float w, float h){
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = slotCount++;
+        basePositions.resize((size_t) slotCount * 4);
+        vertices.resize((size_t) slotCount * 4);
+        int first = slot * 4;
+        const int corners[6] = {0, 1, 2, 2, 3, 0};
+        for (int corner : corners) {
+            indices.push_back(first + corner);
+        }
+    }
+    SDL_FPoint* base = &basePositions[(size_t) slot * 4];
+    base[0] = {x, y};
+    base[1] = {x + w, y};
+    base[2] = {x + w, y + h};
+    base[3] = {x, y + h};
+    for (int i = 0; i < 4; i++) {
+        vertices[(size_t) slot * 4 + i].color = color;
+        vertices[(size_t) slot * 4 + i].tex_coord = {0.0f, 0.0f};
+    }
+    rotateSlot(slot);
+    owner.push_back(slot);
+}
+
+/**
+ * @name releaseSlots
+ * @brief Collapses a line's quads to a point, so they draw nothing, and hands the slots back
+ * @param owner - slot list of the row or column, emptied
+ * @memberof WallGeometry
+ */
+void WallGeometry::releaseSlots(std::vector<int>& owner){
+    for (int slot : owner) {
+        for (int i = 0; i < 4; i++) {
+            basePositions[(size_t) slot * 4 + i] = {0.0f, 0.0f};
+            vertices[(size_t) slot * 4 + i].position = {0.0f, 0.0f};
+        }
+        freeSlots.push_back(slot);
+    }
+    owner.clear();
+}
+
+/**
+ * @name rotateSlot
+ * @brief Applies the current rotation to one slot, clockwise like SDL_RenderCopyEx
+ * @param slot
+ * @memberof WallGeometry
+ */
+void WallGeometry::rotateSlot(int slot){
+    for (int i = slot * 4; i < slot * 4 + 4; i++) {
+        float dx = basePositions[i].x - rotatedCenter.x;
+        float dy = basePositions[i].y - rotatedCenter.y;
+        vertices[i].position = {rotatedCenter.x + dx * angleCos - dy * angleSin,
+                                rotatedCenter.y + dx * angleSin + dy * angleCos};
+    }
+}
+
+/**
+ * @name draw
+ * @brief Draws every wall with a single SDL_RenderGeometry call. The vertices are re-rotated only
+ * if the angle or center moved since the last draw.
+ * @param renderer
+ * @param angle - degrees, clockwise
+ * @param center - rotation center in pixels
+ * @memberof WallGeometry
+ */
+void WallGeometry::draw(SDL_Renderer* renderer, float angle, SDL_FPoint center){
+    if (angle != rotatedAngle || center.x != rotatedCenter.x || center.y != rotatedCenter.y) {
+        rotatedAngle = angle;
+        rotatedCenter = center;
+        float radians = angle * 3.14159265f / 180.0f;
+        angleSin = std::sin(radians);
+        angleCos = std::cos(radians);
+        for (int slot = 0; slot < slotCount; slot++) {
+            rotateSlot(slot);
+        }
+    }
+    if (indices.empty()) {
+        return;
+    }
+    SDL_RenderGeometry(renderer, nullptr, vertices.data(), (int) vertices.size(),
+        indices.data(), (int) indices.size());
+}